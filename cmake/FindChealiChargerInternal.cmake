@@ -110,3 +110,10 @@ MACRO(CHEALI_GENERATE_AVR_EXEC)
     endif(BASH)
 
 ENDMACRO(CHEALI_GENERATE_AVR_EXEC)
+
+
+
+MACRO(CHEALI_GENERATE_HOST_EXEC)
+    #the simulator is run by hand, it gets a short name
+    add_executable(${name} ${ALL_SOURCE_FILES})
+ENDMACRO(CHEALI_GENERATE_HOST_EXEC)
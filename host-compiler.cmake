@@ -0,0 +1,10 @@
+
+#host simulation: 32bit int like on the M0517
+SET(CTUNING "-funsigned-char -funsigned-bitfields")
+
+SET(CFLAGS "${CTUNING} -O2 -Wall -g -std=c11")
+#eeprom::Data is packed (CHEALI_EEPROM_PACKED): &eeprom::data.<member> is an eeprom address,
+#it is only passed to eeprom::read/write (memcpy), never dereferenced
+SET(CXXFLAGS "${CTUNING} -O2 -Wall -Wno-address-of-packed-member -g -fno-exceptions -std=c++11")
+SET(CMAKE_C_FLAGS   "${CMAKE_C_FLAGS}   ${CFLAGS}")
+SET(CMAKE_CXX_FLAGS "${CMAKE_CXX_FLAGS} ${CXXFLAGS}")
@@ -24,9 +24,22 @@
 #include "eeprom.h"
 #include "atomic.h"
 #include "Balancer.h"
+#include "Utils.h"
+#include "Units.h"
 
-#define ANALOG_INPUTS_E_OUT_dt_FACTOR   50
-#define ANALOG_INPUTS_E_OUT_DIVIDER     100
+#ifndef ANALOG_INPUTS_STABLE_VALUE_ERROR
+#define ANALOG_INPUTS_STABLE_VALUE_ERROR    6
+#endif
+
+// Cout and Eout integrate the Iout samples of every ADC round (also the rounds
+// which are not averaged), over the timer interrupts between the last rounds
+// of two integrations, the remainders keep the part below 1uAh and 1uWh
+#define ANALOG_INPUTS_TICKS_PER_HOUR    (3600UL*1000000/TIMER_INTERRUPT_PERIOD_MICROSECONDS)
+// mA*ticks per uAh and 0.1mW*ticks per uWh
+#define ANALOG_INPUTS_CHARGE_REST_PER_UAH   (ANALOG_INPUTS_TICKS_PER_HOUR/1000)
+#define ANALOG_INPUTS_ENERGY_REST_PER_UWH   (ANALOG_INPUTS_TICKS_PER_HOUR/100)
+// P[0.1mW] * ticks must fit into uint32_t
+#define ANALOG_INPUTS_INTEGRATION_MAX_TICKS 512
 
 #define ANALOG_INPUTS_ADC_MEASUREMENTS_COUNT (ANALOG_INPUTS_ADC_ROUND_MAX_COUNT*ANALOG_INPUTS_ADC_BURST_COUNT)
 
@@ -79,10 +92,19 @@ namespace AnalogInputs {
     uint16_t    deltaStartTimeU16_;
     bool        enable_deltaVoutMax_;
 
-    uint32_t    i_charge_;
-    uint32_t    i_Eout_;
-    uint8_t     i_Eout_dt_;
+    uint32_t    chargeUAh_;
+    uint32_t    chargeRest_;
+    uint32_t    energyUWh_;
+    uint32_t    energyRest_;
+    uint32_t    lastIntegration_;
 
+    volatile uint16_t  i_integrationRounds_;
+    volatile uint32_t  i_integrationSumIsmps_;
+    volatile uint32_t  i_integrationSumIdischarge_;
+    volatile uint32_t  i_integrationTime_;
+
+    void resetIntegration();
+    void integrate(ValueType V);
     void _resetAvr();
     void _resetDeltaAvr();
     void resetADC();
@@ -247,11 +269,9 @@ void AnalogInputs::resetMeasurement()
 
 void AnalogInputs::resetAccumulatedMeasurements()
 {
-    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
-        i_charge_ = 0;
-        i_Eout_ = 0;
-        i_Eout_dt_ = ANALOG_INPUTS_E_OUT_dt_FACTOR;
-    }
+    chargeUAh_ = chargeRest_ = 0;
+    energyUWh_ = energyRest_ = 0;
+    resetIntegration();
     setReal(deltaVoutMax, getVout());
     deltaLastT_ = getRealValue(Textern);
 
@@ -263,6 +283,14 @@ void AnalogInputs::resetAccumulatedMeasurements()
     setReal(deltaTextern, 0);
 }
 
+void AnalogInputs::restoreAccumulatedMeasurements(ValueType charge, ValueType energy)
+{
+    chargeUAh_ = charge * 1000UL;
+    energyUWh_ = energy * 10000UL;
+    setReal(Cout, charge);
+    setReal(Eout, energy);
+}
+
 void AnalogInputs::reset()
 {
     calculationCount_ = 0;
@@ -310,6 +338,8 @@ AnalogInputs::ValueType AnalogInputs::calibrateValue(Name name, ValueType x)
     a  =  x;   a -= p0.x;
     y *= a;
     a  = p1.x; a -= p0.x;
+    //blank eeprom: p0 == p1
+    if(a == 0) return 0;
     y /= a;
     y += p0.y;
 
@@ -330,6 +360,7 @@ AnalogInputs::ValueType AnalogInputs::reverseCalibrateValue(Name name, ValueType
     a  =  y;   a -= p0.y;
     x *= a;
     a  = p1.y; a -= p0.y;
+    if(a == 0) return 0;
     x /= a;
     x += p0.x;
 
@@ -376,53 +407,89 @@ void AnalogInputs::printRealValue(Name name, uint8_t dig)
     lcdPrintAnalog(x, dig, t);
 }
 
-static inline uint32_t toHoursBasis(uint32_t accumulator) {
-    uint32_t retu = accumulator;
-    retu /= 1000000/TIMER_INTERRUPT_PERIOD_MICROSECONDS
-        * 3600/TIMER_SLOW_INTERRUPT_INTERVAL;
-    return retu;
+AnalogInputs::ValueType AnalogInputs::getCharge()
+{
+    STATIC_ASSERT(ANALOG_CHARGE(1.0) == 1000);
+    return Utils::divide<1000>(chargeUAh_);
 }
 
-AnalogInputs::ValueType AnalogInputs::getCharge()
+AnalogInputs::ValueType AnalogInputs::getEout()
 {
-    //check units
-    STATIC_ASSERT(ANALOG_AMP(1.0) == ANALOG_CHARGE(1.0));
+    STATIC_ASSERT(ANALOG_WATTH(1.0) == 100);
+    return Utils::divide<10000>(energyUWh_);
+}
 
-    uint32_t retu;
-    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
-        retu = i_charge_;
-    }
-    return toHoursBasis(retu);
+uint32_t AnalogInputs::getChargeMicroAh()
+{
+    return chargeUAh_;
 }
 
+uint32_t AnalogInputs::getEoutMicroWh()
+{
+    return energyUWh_;
+}
 
-AnalogInputs::ValueType AnalogInputs::getEout()
+void AnalogInputs::resetIntegration()
 {
-    uint32_t retu;
     ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
-        retu = i_Eout_;
+        i_integrationRounds_ = 0;
+        i_integrationSumIsmps_ = 0;
+        i_integrationSumIdischarge_ = 0;
+        lastIntegration_ = Time::getInterrupts();
     }
+}
 
-    //check units
-    STATIC_ASSERT(uint32_t(ANALOG_AMP(1.0))*ANALOG_VOLT(1.0)
-            / (ANALOG_INPUTS_E_OUT_DIVIDER*ANALOG_INPUTS_E_OUT_dt_FACTOR)
-            == 2 * ANALOG_WATTH(1.0));
-    retu /= 2;
-
-    return toHoursBasis(retu);
+void AnalogInputs::intterruptIntegrate()
+{
+    //only if the main loop stops for minutes
+    if(i_integrationRounds_ == UINT16_MAX)
+        return;
+    i_integrationRounds_++;
+    i_integrationSumIsmps_ += i_adc_[Ismps];
+    i_integrationSumIdischarge_ += i_adc_[Idischarge];
+    i_integrationTime_ = Time::getInterrupts();
 }
 
-void AnalogInputs::doSlowInterrupt()
+void AnalogInputs::integrate(ValueType V)
 {
-    i_charge_ += getIout();
+    uint16_t rounds;
+    uint32_t sumIsmps, sumIdischarge, now;
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+        rounds = i_integrationRounds_;
+        sumIsmps = i_integrationSumIsmps_;
+        sumIdischarge = i_integrationSumIdischarge_;
+        now = i_integrationTime_;
+        i_integrationRounds_ = 0;
+        i_integrationSumIsmps_ = 0;
+        i_integrationSumIdischarge_ = 0;
+    }
+    if(rounds == 0)
+        return;
+    uint32_t dt = now - lastIntegration_;
+    lastIntegration_ = now;
 
-    if(--i_Eout_dt_ == 0) {
-        i_Eout_dt_ = ANALOG_INPUTS_E_OUT_dt_FACTOR;
+    //the calibration is linear: calibrated mean == mean of the calibrated samples
+    ValueType I = 0;
+    if(Discharger::isPowerOn()) {
+        I = calibrateValue(Idischarge, sumIdischarge / rounds);
+    } else if (SMPS::isPowerOn()) {
+        I = calibrateValue(Ismps, sumIsmps / rounds);
+    }
 
-        uint32_t P = getIout();
-        P *= getVout();
-        uint32_t E_since_previous_measurement = P / ANALOG_INPUTS_E_OUT_DIVIDER;
-        i_Eout_ += E_since_previous_measurement;
+    //0.1mW
+    uint32_t P = Units::rescale<-4>(Units::Current(I) * Units::Voltage(V)).raw();
+    while(dt) {
+        uint16_t step = dt < ANALOG_INPUTS_INTEGRATION_MAX_TICKS ? dt : ANALOG_INPUTS_INTEGRATION_MAX_TICKS;
+        dt -= step;
+        chargeRest_ += uint32_t(I) * step;
+        energyRest_ += P * step;
+
+        uint32_t c = Utils::divide<ANALOG_INPUTS_CHARGE_REST_PER_UAH>(chargeRest_);
+        chargeRest_ -= c * ANALOG_INPUTS_CHARGE_REST_PER_UAH;
+        chargeUAh_ += c;
+        uint32_t e = Utils::divide<ANALOG_INPUTS_ENERGY_REST_PER_UWH>(energyRest_);
+        energyRest_ -= e * ANALOG_INPUTS_ENERGY_REST_PER_UWH;
+        energyUWh_ += e;
     }
 }
 
@@ -442,7 +509,7 @@ void AnalogInputs::doIdle()
 
 void AnalogInputs::setRealBasedOnAvr(AnalogInputs::Name name)
 {
-    avrAdc_[name] = i_avrSum_[name] / ANALOG_INPUTS_ADC_MEASUREMENTS_COUNT;
+    avrAdc_[name] = Utils::divide<ANALOG_INPUTS_ADC_MEASUREMENTS_COUNT>(i_avrSum_[name]);
     ValueType real = calibrateValue(name, avrAdc_[name]);
     setReal(name, real);
 }
@@ -596,10 +663,10 @@ void AnalogInputs::finalizeFullVirtualMeasurement()
         IoutValue = getRealValue(Ismps);
     }
 
-    uint32_t P = IoutValue;
-    P *= out;
-    P /= 10000;
-    setReal(Pout, P);
+    Units::Power P = Units::saturate(Units::convert<Units::Centiwatt>(
+            Units::Current(IoutValue) * Units::Voltage(out)));
+    setReal(Pout, P.raw());
+    integrate(out);
 
     setReal(Iout, IoutValue);
     setReal(Cout, getCharge());
@@ -608,7 +675,7 @@ void AnalogInputs::finalizeFullVirtualMeasurement()
 
 void AnalogInputs::setReal(Name name, ValueType real)
 {
-    if(absDiff(real_[name], real) > STABLE_VALUE_ERROR)
+    if(absDiff(real_[name], real) > ANALOG_INPUTS_STABLE_VALUE_ERROR)
         stableCount_[name] = 0;
     else
         stableCount_[name]++;
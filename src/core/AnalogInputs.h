@@ -126,6 +126,9 @@ namespace AnalogInputs {
     ValueType getDeltaCount();
     ValueType getCharge();
     ValueType getEout();
+    //Cout and Eout with the full resolution
+    uint32_t getChargeMicroAh();
+    uint32_t getEoutMicroWh();
     void enableDeltaVoutMax(bool enable);
 
     extern uint16_t connectedBalancePortCells;
@@ -148,6 +151,8 @@ namespace AnalogInputs {
 
     void resetMeasurement();
     void resetAccumulatedMeasurements();
+    //Cout and Eout of a resumed program (SessionJournal)
+    void restoreAccumulatedMeasurements(ValueType charge, ValueType energy);
     void powerOn(bool enableBatteryOutput = true);
     void powerOff();
 
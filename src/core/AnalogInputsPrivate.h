@@ -34,10 +34,11 @@ namespace AnalogInputs {
     extern volatile bool onTintern_;
 
     void intterruptFinalizeMeasurement();
+    //end of every ADC round: Iout samples for Cout and Eout
+    void intterruptIntegrate();
     void resetStable();
 
     void doIdle();
-    void doSlowInterrupt();
 
     //calibration
     void getCalibrationPoint(CalibrationPoint &p, Name name, uint8_t i);
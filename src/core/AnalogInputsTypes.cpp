@@ -20,14 +20,12 @@
 #include <stdint.h>
 
 #include "AnalogInputsTypes.h"
+#include "Utils.h"
+#include "Units.h"
 
 AnalogInputs::ValueType AnalogInputs::evalI(AnalogInputs::ValueType P, AnalogInputs::ValueType U) {
-    uint32_t i = P;
-    i *= ANALOG_VOLT(1);
-    i /= U;
-    i *= ANALOG_AMP(1);
-    i /= ANALOG_WATT(1);
-    if (i > UINT16_MAX)
-        i = UINT16_MAX;
-    return i;
+    //10^-5 W / mV = 10^-2 A (10mA), convert<Milliamp> multiplies by 10
+    Units::Current I = Units::saturate(Units::convert<Units::Milliamp>(
+            Units::rescale<-5>(Units::Power(P)) / Units::Voltage(U)));
+    return I.raw();
 }
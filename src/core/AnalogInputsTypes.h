@@ -53,7 +53,6 @@ namespace AnalogInputs {
         Unknown
     };
 
-    static const ValueType  STABLE_VALUE_ERROR  = 6;
     static const uint16_t   STABLE_MIN_VALUE    = 3;
 
     AnalogInputs::ValueType evalI(AnalogInputs::ValueType P, AnalogInputs::ValueType U);
@@ -32,18 +32,34 @@
 #include "Screen.h"
 #include "helper.h"
 #include "memory.h"
+#include "BootInfo.h"
+#include "IsrProfiler.h"
+#include "SerialCommand.h"
+#include "SessionJournal.h"
+#include "Keyboard.h"
 
 
+static uint16_t welcome;
+
 void setup()
 {
     hardware::initializePins();
     cpu::init();
+    IsrProfiler::initialize();
 
     hardware::initialize();
     Time::initialize();
     SMPS::initialize();
     Discharger::initialize();
     AnalogInputs::initialize();
+    BootInfo::mark(BootInfo::Init);
+
+    //show something as soon as possible, the rest is done behind the welcome screen
+    Screen::initialize();
+    Screen::displayWelcomeScreen();
+    welcome = Time::getMilisecondsU16();
+    BootInfo::mark(BootInfo::Screen);
+
     Serial::initialize();
 
 #ifdef ENABLE_STACK_INFO
@@ -51,9 +67,26 @@ void setup()
 #endif
 
     Settings::load();
-    Screen::initialize();
+    BootInfo::mark(BootInfo::Settings);
+}
 
-    Screen::runWelcomeScreen();
+//the welcome screen stays up to SCREEN_WELCOME_DELAY_MS,
+//a key press or a serial command ends it early
+void welcomeWait()
+{
+    while(Time::diffU16(welcome, Time::getMilisecondsU16()) < SCREEN_WELCOME_DELAY_MS) {
+#ifdef ENABLE_KEYBOARD_INTERRUPT
+        Time::doIdle();
+        Time::sleep();
+        bool key = Keyboard::isEventPending() && Keyboard::getPressedWithDelay() != BUTTON_NONE;
+#else
+        //runs Time::doIdle(), returns after a few BUTTON_DELAY
+        bool key = Keyboard::getPressedWithDelay() != BUTTON_NONE;
+#endif
+        if(key || SerialCommand::takeReceived())
+            break;
+    }
+    BootInfo::mark(BootInfo::Welcome);
 }
 
 
@@ -61,9 +94,16 @@ int main()
 {
     setup();
 #ifdef ENABLE_HELPER
+    welcomeWait();
     helperMain();
 #else
     eeprom::check();
+    BootInfo::mark(BootInfo::Ready);
+    welcomeWait();
+    if(SerialCommand::keepOpen())
+        BootInfo::report();
+    SessionJournal::runResume();
     MainMenu::run();
 #endif
+    return 0;
 }
@@ -24,13 +24,34 @@
 #define LCD_COLUMNS             16
 
 #define ENABLE_SERIAL_LOG
+//serial log as BB3 SCPI commands ("SENS:DLOG:TRACE:DATA ..." lines, no checksum),
+//undefine for the "$<channel>;...;<crc>" frames (see: utils/cheali-fleet/chealistream.py)
+#define ENABLE_SERIAL_LOG_BB3
+//remote control over the serial port RX line, see: SerialCommand.h
+#define ENABLE_SERIAL_COMMAND
+//record boot phase times, reported with the "B" serial command (see: BootInfo.h)
+#define ENABLE_BOOT_INFO
+//interrupt and main loop timing on the serial log channel 3, not sent with ENABLE_SERIAL_LOG_BB3 (see: IsrProfiler.h)
+//#define ENABLE_ISR_PROFILER
 #define ENABLE_TIME_LIMIT
 #define ENABLE_LCD_RAM_CG
+//draw into a RAM copy of the display, send only changed characters (see: lcdFlush)
+#define ENABLE_LCD_FRAMEBUFFER
+//send LCD commands from the timer interrupt, no busy waiting (see: LiquidCrystal::doInterrupt)
+#define ENABLE_LCD_ASYNC
+//sample and debounce the keyboard in the timer interrupt, queue key events (see: Keyboard::doInterrupt)
+#define ENABLE_KEYBOARD_INTERRUPT
 #define ENABLE_SCREEN_ANIMATION
 //#define ENABLE_SCREEN_KNIGHTRIDEREFFECT
 
 #define ENABLE_EEPROM_CRC
+//settings and program data are saved to RAM, eeprom is updated later from Time::doIdle (see: eeprom::doIdle)
+#define ENABLE_EEPROM_WRITE_BEHIND
+//convert eeprom sections written by older firmware instead of resetting them (see: utils/eepromExtractor/layouts.py)
+#define ENABLE_EEPROM_MIGRATION
 #define ENABLE_EEPROM_RESTORE_DEFAULT
+//save the state of the running program, offer to resume it after a reset (see: SessionJournal.h)
+#define ENABLE_SESSION_JOURNAL
 #define ENABLE_SETTINGS_MENU_RESET
 
 #define ENABLE_CALIBRATION
@@ -29,6 +29,7 @@
 #include "Balancer.h"
 #include "Monitor.h"
 #include "memory.h"
+#include "eeprom.h"
 #include "StartInfoStrategy.h"
 #include "Buzzer.h"
 #include "Settings.h"
@@ -36,6 +37,7 @@
 #include "DelayStrategy.h"
 #include "ProgramDCcycle.h"
 #include "Calibration.h"
+#include "SessionJournal.h"
 
 namespace Program {
     ProgramType programType;
@@ -148,20 +150,21 @@ void Program::resetAccumulatedMeasurements()
 {
     Monitor::resetAccumulatedMeasurements();
     AnalogInputs::resetAccumulatedMeasurements();
+    SessionJournal::restoreAccumulatedMeasurements();
 }
 
 
 Strategy::statusType Program::runWithoutInfo(ProgramType prog)
 {
-    resetAccumulatedMeasurements();
-
-    setupProgramType(prog);
     switch(prog) {
         case Program::CapacityCheck:
             return ProgramDCcycle::runDCcycle(1, 3);
         case Program::DischargeChargeCycle:
             return ProgramDCcycle::runDCcycle(0, ProgramData::battery.DCcycles*2 - 1);
         default:
+            //also every step of runDCcycle()
+            resetAccumulatedMeasurements();
+            setupProgramType(prog);
             return Strategy::doStrategy();
     }
 }
@@ -182,6 +185,8 @@ void Program::run(ProgramType prog)
         return;
 #endif
 
+    //write pending changes before charging starts
+    eeprom::flush();
     dischargeOutputCapacitor();
 
     programType = prog;
@@ -201,6 +206,7 @@ void Program::run(ProgramType prog)
         Strategy::exitImmediately = false;
         Buzzer::soundStartProgram();
 
+        SessionJournal::start();
         runWithoutInfo(programType);
 
         Monitor::powerOff();
@@ -208,4 +214,5 @@ void Program::run(ProgramType prog)
     AnalogInputs::powerOff();
     SerialLog::powerOff();
     Screen::powerOff();
+    programState = Done;
 }
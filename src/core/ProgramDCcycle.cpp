@@ -22,6 +22,7 @@
 #include "Settings.h"
 #include "Monitor.h"
 #include "ScreenCycle.h"
+#include "SessionJournal.h"
 
 using namespace Program;
 
@@ -41,7 +42,7 @@ Strategy::statusType ProgramDCcycle::runDCcycle(uint8_t firstCycle, uint8_t last
 {
     Strategy::statusType status;
     Strategy::exitImmediately = true;
-    currentCycle = firstCycle;
+    currentCycle = SessionJournal::resumeCycle(firstCycle, lastCycle);
     while(true) {
         if (currentCycle == lastCycle) {
             Strategy::exitImmediately = false;
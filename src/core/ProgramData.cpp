@@ -230,14 +230,18 @@ void ProgramData::check()
 
 void ProgramData::loadProgramData(uint8_t index)
 {
-    eeprom::read(battery, &eeprom::data.battery[index]);
+    //the main menu loads every visible slot, don't force the queued write out
+    eeprom::readProgramData(index, battery);
     check();
 }
 
 void ProgramData::saveProgramData(uint8_t index)
 {
-    eeprom::write(&eeprom::data.battery[index], battery);
-    eeprom::restoreProgramDataCRC();
+#ifdef ENABLE_EEPROM_WRITE_BEHIND
+    eeprom::writeBehindProgramData(index);
+#else
+    eeprom::writeProgramData(index);
+#endif
 }
 
 void ProgramData::restoreDefault()
@@ -248,6 +252,7 @@ void ProgramData::restoreDefault()
     for(int i=0;i< MAX_PROGRAMS;i++) {
         saveProgramData(i);
     }
+    eeprom::flush();
     eeprom::restoreProgramDataCRC();
 }
 
@@ -0,0 +1,299 @@
+/*
+    cheali-charger - open source firmware for a variety of LiPo chargers
+    Copyright (C) 2013  Paweł Stawicki. All right reserved.
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include <string.h>
+#include "SessionJournal.h"
+#include "eeprom.h"
+#include "Program.h"
+#include "ProgramData.h"
+#include "ProgramDCcycle.h"
+#include "Monitor.h"
+#include "Screen.h"
+#include "Utils.h"
+#include "Time.h"
+#include "memory.h"
+
+#ifdef ENABLE_SESSION_JOURNAL
+
+STATIC_ASSERT(SESSION_JOURNAL_SLOTS >= 2);
+
+#ifdef E2END
+#ifndef EEPROM_START
+#define EEPROM_START 0
+#endif
+//a fixed address at the end of the eeprom, eeprom::data is the only EEMEM variable (at EEPROM_START)
+#define SESSION_JOURNAL_ADDRESS     (E2END + 1 - SESSION_JOURNAL_SLOTS * sizeof(SessionJournal::Record))
+STATIC_ASSERT(EEPROM_START + sizeof(eeprom::Data) <= SESSION_JOURNAL_ADDRESS);
+#endif
+
+#ifdef EEPROM_ERASE_PAGE_SIZE
+//whole pages, a record is never split between two pages
+STATIC_ASSERT(SESSION_JOURNAL_ADDRESS % EEPROM_ERASE_PAGE_SIZE == 0);
+STATIC_ASSERT(EEPROM_ERASE_PAGE_SIZE % sizeof(SessionJournal::Record) == 0);
+#endif
+
+namespace SessionJournal {
+#ifdef E2END
+    Record * const journal = (Record *) SESSION_JOURNAL_ADDRESS;
+#else
+    Record journal[SESSION_JOURNAL_SLOTS] EEMEM;
+#endif
+
+    bool on_;
+    uint16_t lastWrite_;
+    //the time to the next write, doubled while the DC cycle stays the same
+    uint16_t interval_;
+    uint8_t cycle_;
+    uint16_t battery_;
+    //the slot and the sequence number of the next record
+    uint8_t next_;
+    uint16_t sequence_;
+
+    //the resumed program, consumed by restoreAccumulatedMeasurements()
+    bool resume_;
+    Record resumed_;
+
+    //CRC-16 like the eeprom data, a zeroed or erased record does not match
+    uint16_t getChecksum(const void * data, uint8_t size) {
+        const uint8_t * p = (const uint8_t *) data;
+        uint16_t crc = 0xffff;
+        for(uint8_t i = 0; i < size; i++)
+            crc = Utils::crc16Update(crc, p[i]);
+        return crc;
+    }
+
+    uint16_t getRecordChecksum(const Record &r) {
+        return getChecksum(&r, sizeof(r) - sizeof(r.checksum));
+    }
+
+    bool isValid(const Record &r) {
+        return r.checksum == getRecordChecksum(r);
+    }
+
+    bool canResume(const Record &r) {
+        return isValid(r) && r.programType < Program::EditBattery;
+    }
+
+    //finds the newest record, sets next_ and sequence_
+    bool readLast(Record &r) {
+        Record n;
+        for(uint8_t i = 0; i < SESSION_JOURNAL_SLOTS; i++) {
+            eeprom::read(r, &journal[i]);
+            if(!isValid(r))
+                continue;
+            uint8_t j = i + 1;
+            if(j == SESSION_JOURNAL_SLOTS)
+                j = 0;
+            eeprom::read(n, &journal[j]);
+            if(isValid(n) && n.sequence == uint16_t(r.sequence + 1))
+                continue;
+            next_ = j;
+            sequence_ = r.sequence + 1;
+            return true;
+        }
+        next_ = 0;
+        sequence_ = 0;
+        return false;
+    }
+
+#ifdef EEPROM_ERASE_PAGE_SIZE
+    bool isErased(uint8_t slot) {
+        Record r;
+        eeprom::read(r, &journal[slot]);
+        const uint8_t * p = (const uint8_t *) &r;
+        for(uint8_t i = 0; i < sizeof(r); i++) {
+            if(p[i] != 0xff)
+                return false;
+        }
+        return true;
+    }
+
+    //while the output is off
+    void erase() {
+        for(uint8_t i = 0; i < SESSION_JOURNAL_SLOTS; i += EEPROM_ERASE_PAGE_SIZE / sizeof(Record)) {
+            if(!isErased(i))
+                eeprom::erasePage(&journal[i]);
+        }
+        next_ = 0;
+    }
+
+    void writeRecord(const Record &r) {
+        //the ring wrapped: the CPU is stalled by the page erase
+        if(!isErased(next_))
+            eeprom::erasePage(&journal[next_]);
+        //erased words are programmed without a page erase
+        eeprom::write(&journal[next_], r);
+    }
+
+    inline void doWrite() {}
+#else
+    //the record written by doWrite(), one byte per call
+    Record pending_;
+    uint8_t pendingSlot_;
+    uint8_t pendingByte_ = sizeof(Record);
+
+    void doWrite() {
+        if(pendingByte_ == sizeof(Record))
+            return;
+        uint8_t * adr = ((uint8_t *) &journal[pendingSlot_]) + pendingByte_;
+        if(eeprom::tryUpdateByte(adr, ((const uint8_t *) &pending_)[pendingByte_]))
+            pendingByte_++;
+    }
+
+    void flush() {
+        while(pendingByte_ != sizeof(Record))
+            doWrite();
+    }
+
+    inline void erase() {}
+
+    void writeRecord(const Record &r) {
+        flush();
+        pending_ = r;
+        pendingSlot_ = next_;
+        pendingByte_ = 0;
+    }
+#endif
+
+    void append(Record &r) {
+        r.sequence = sequence_++;
+        r.checksum = getRecordChecksum(r);
+        writeRecord(r);
+        if(++next_ == SESSION_JOURNAL_SLOTS)
+            next_ = 0;
+    }
+
+    void write() {
+        Record r;
+        r.programType = Program::programType;
+        r.currentCycle = ProgramDCcycle::currentCycle;
+        r.battery = battery_;
+        r.charge = AnalogInputs::getCharge();
+        r.energy = AnalogInputs::getEout();
+        r.timeMin = Monitor::getTimeSec() / 60;
+        r.chargeDischargeTimeMin = Monitor::getTotalChargeDischargeTimeMin();
+        append(r);
+    }
+
+    void writeDone() {
+        Record r;
+        memset(&r, 0, sizeof(r));
+        r.programType = Program::LAST_PROGRAM_TYPE;
+        append(r);
+    }
+
+    //ProgramData::battery (the menus) is not touched, the slots are saved
+    //after ProgramData::check(): a slot matches without loadProgramData()
+    int8_t findProgramData(uint16_t battery) {
+        ProgramData::Battery b;
+        for(uint8_t i = 0; i < MAX_PROGRAMS; i++) {
+            eeprom::readProgramData(i, b);
+            if(getChecksum(&b, sizeof(b)) == battery)
+                return i;
+        }
+        return -1;
+    }
+
+} // namespace SessionJournal
+
+
+void SessionJournal::start()
+{
+    battery_ = getChecksum(&ProgramData::battery, sizeof(ProgramData::battery));
+    on_ = true;
+    lastWrite_ = Time::getSecondsU16();
+    interval_ = SESSION_JOURNAL_INTERVAL_S;
+    cycle_ = ProgramDCcycle::currentCycle;
+    //the previous program is done or resumed (resumed_)
+    erase();
+    if(resume_) {
+        //Cout, Eout and the DC cycle are restored later, keep them for a reset before the next write()
+        Record r = resumed_;
+        append(r);
+    } else {
+        write();
+    }
+}
+
+void SessionJournal::stop()
+{
+    //Monitor::powerOff() is called again at the end of Program::run()
+    if(!on_)
+        return;
+    on_ = false;
+    if(Program::stopReason != Monitor::string_inputVoltageToLow)
+        writeDone();
+}
+
+void SessionJournal::doIdle()
+{
+    doWrite();
+    //nothing to resume after the program is complete or stopped by an error
+    if(!on_ || !Monitor::isPowerOn())
+        return;
+    uint16_t now = Time::getSecondsU16();
+    if(cycle_ != ProgramDCcycle::currentCycle) {
+        //the next DC cycle is written at once
+        cycle_ = ProgramDCcycle::currentCycle;
+        interval_ = SESSION_JOURNAL_INTERVAL_S;
+    } else if(Time::diffU16(lastWrite_, now) < interval_) {
+        return;
+    } else if(interval_ < SESSION_JOURNAL_MAX_INTERVAL_S / 2) {
+        interval_ *= 2;
+    } else {
+        interval_ = SESSION_JOURNAL_MAX_INTERVAL_S;
+    }
+    lastWrite_ = now;
+    write();
+}
+
+void SessionJournal::runResume()
+{
+    Record r;
+    if(!readLast(r) || !canResume(r))
+        return;
+
+    int8_t index = findProgramData(r.battery);
+    if(index >= 0 && Screen::runAskResumeProgram(index)) {
+        ProgramData::loadProgramData(index);
+        resumed_ = r;
+        resume_ = true;
+        Program::run((Program::ProgramType) r.programType);
+        resume_ = false;
+    } else {
+        //declined or the program data was changed
+        writeDone();
+    }
+}
+
+uint8_t SessionJournal::resumeCycle(uint8_t firstCycle, uint8_t lastCycle)
+{
+    if(resume_ && firstCycle <= resumed_.currentCycle && resumed_.currentCycle <= lastCycle)
+        return resumed_.currentCycle;
+    return firstCycle;
+}
+
+void SessionJournal::restoreAccumulatedMeasurements()
+{
+    if(!resume_)
+        return;
+    resume_ = false;
+    AnalogInputs::restoreAccumulatedMeasurements(resumed_.charge, resumed_.energy);
+    Monitor::restoreAccumulatedMeasurements(resumed_.timeMin, resumed_.chargeDischargeTimeMin);
+}
+
+#endif //ENABLE_SESSION_JOURNAL
@@ -0,0 +1,116 @@
+/*
+    cheali-charger - open source firmware for a variety of LiPo chargers
+    Copyright (C) 2013  Paweł Stawicki. All right reserved.
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#ifndef SESSION_JOURNAL_H_
+#define SESSION_JOURNAL_H_
+
+#include "AnalogInputs.h"
+#include "memory.h"
+
+/*
+ * the state of the running program (Cout, Eout, times, DC cycle) is appended to
+ * a ring of records at the end of the eeprom (data flash on the M0517) every
+ * SESSION_JOURNAL_INTERVAL_S..SESSION_JOURNAL_MAX_INTERVAL_S, after a brownout or reset the program can be
+ * resumed with it (runResume())
+ *
+ * write cost, measured in the simulator a record changes 7-10 of its 16 bytes:
+ * atmega32: 8.5ms per changed byte, doIdle() starts one byte per call
+ *   instead of blocking the main loop for 60-90ms (eeprom_update_block)
+ * M0517: programming the 4 words of an erased slot, the pages are erased
+ *   by start() before the output is on, a page erase with the CPU stalled
+ *   during the program is needed only when the ring wraps
+ *   (after SESSION_JOURNAL_SLOTS records, then every 32 records)
+ *
+ * endurance: the sequence and checksum bytes change in every record,
+ * the interval doubles after each write up to SESSION_JOURNAL_MAX_INTERVAL_S
+ * while the DC cycle stays the same, a new cycle is written at once and starts
+ * again at SESSION_JOURNAL_INTERVAL_S (a resumed program loses up to one interval
+ * of Cout/Eout)
+ * atmega32 (2 slots, 100k cycles): a slot is rewritten every 960s in a long
+ *   phase: 26,000 h of charging (3,300 h with a fixed 60s interval),
+ *   a 1h charge writes 11 records (start, 60, 180, 420s, then every 480s, done):
+ *   18,000 such programs
+ */
+#ifndef SESSION_JOURNAL_INTERVAL_S
+#define SESSION_JOURNAL_INTERVAL_S      60
+#endif
+
+#ifndef SESSION_JOURNAL_MAX_INTERVAL_S
+#ifdef EEPROM_ERASE_PAGE_SIZE
+//M0517: a page is erased every 4 * 32 records
+#define SESSION_JOURNAL_MAX_INTERVAL_S  SESSION_JOURNAL_INTERVAL_S
+#else
+#define SESSION_JOURNAL_MAX_INTERVAL_S  480
+#endif
+#endif
+
+#ifndef SESSION_JOURNAL_SLOTS
+#ifdef EEPROM_ERASE_PAGE_SIZE
+//M0517: the last 4 data flash pages, 128 records (2 hours)
+#define SESSION_JOURNAL_SLOTS           (4 * EEPROM_ERASE_PAGE_SIZE / sizeof(SessionJournal::Record))
+#else
+//atmega32: the eeprom left after eeprom::Data
+#define SESSION_JOURNAL_SLOTS           2
+#endif
+#endif
+
+namespace SessionJournal {
+    struct Record {
+        //the newest record is the one not followed by sequence + 1
+        uint16_t sequence;
+        //Program::ProgramType, Program::LAST_PROGRAM_TYPE: program done
+        uint8_t programType;
+        uint8_t currentCycle;
+        //checksum of ProgramData::battery, finds the program data slot
+        uint16_t battery;
+        AnalogInputs::ValueType charge;
+        AnalogInputs::ValueType energy;
+        uint16_t timeMin;
+        uint16_t chargeDischargeTimeMin;
+        uint16_t checksum;
+    } CHEALI_EEPROM_PACKED;
+
+#ifndef E2END
+    //host: a RAM array, saved with the eeprom image (Simulator --eeprom)
+    extern Record journal[];
+#endif
+
+#ifdef ENABLE_SESSION_JOURNAL
+    //called from Program::run()
+    void start();
+    //called from Monitor::powerOff(), before the "complete" or "Error" screen waits for a button,
+    //the journal is kept when the input voltage is too low (a brownout follows)
+    void stop();
+    void doIdle();
+
+    //boot: asks to resume the program of the last record
+    void runResume();
+    //the first DC cycle of a resumed program
+    uint8_t resumeCycle(uint8_t firstCycle, uint8_t lastCycle);
+    //Cout, Eout and the times of a resumed program (Program::resetAccumulatedMeasurements)
+    void restoreAccumulatedMeasurements();
+#else
+    inline void start() {}
+    inline void stop() {}
+    inline void doIdle() {}
+    inline void runResume() {}
+    inline uint8_t resumeCycle(uint8_t firstCycle, uint8_t lastCycle) { return firstCycle; }
+    inline void restoreAccumulatedMeasurements() {}
+#endif
+}
+
+#endif /* SESSION_JOURNAL_H_ */
@@ -22,6 +22,7 @@
 #include "Settings.h"
 #include "Monitor.h"
 #include "eeprom.h"
+#include "SerialCommand.h"
 
 #ifndef SETTINGS_EXTERNAL_T_DEFAULT
 #define SETTINGS_EXTERNAL_T_DEFAULT 0
@@ -31,6 +32,10 @@
 #define SETTINGS_ADC_NOISE_DEFAULT  0
 #endif
 
+#ifndef SETTINGS_UART_DEFAULT
+#define SETTINGS_UART_DEFAULT       Settings::Disabled
+#endif
+
 #ifndef SETTINGS_MAX_CHARGE_I
 #define SETTINGS_MAX_CHARGE_I       MAX_CHARGE_I
 #endif
@@ -69,7 +74,7 @@ const Settings defaultSettings PROGMEM = {
         ANALOG_VOLT(10.000),//inputVoltageLow
 
         SETTINGS_ADC_NOISE_DEFAULT, //adcNoise
-        Settings::Disabled, //UART - disabled
+        SETTINGS_UART_DEFAULT, //UART - disabled
         3,                   //57600
         Settings::TempOutput, //UARToutput
         Settings::MenuSimple, //menuType
@@ -87,6 +92,9 @@ const uint32_t Settings::UARTSpeedValue[Settings::UARTSpeeds] PROGMEM = {
 
 
 uint32_t Settings::getUARTspeed() const {
+    //settings are applied before eeprom::check(), they may be garbage
+    if(UARTspeed >= UARTSpeeds)
+        return pgm::read(&UARTSpeedValue[0]);
     return pgm::read(&UARTSpeedValue[UARTspeed]);
 }
 
@@ -96,8 +104,12 @@ void Settings::load() {
 }
 
 void Settings::save() {
+#ifdef ENABLE_EEPROM_WRITE_BEHIND
+    eeprom::writeBehindSettings();
+#else
     eeprom::write(&eeprom::data.settings, settings);
     eeprom::restoreSettingsCRC();
+#endif
 
     settings.apply();
 }
@@ -109,6 +121,7 @@ void Settings::setDefault()
 void Settings::restoreDefault() {
     settings.setDefault();
     Settings::save();
+    eeprom::flush();
 }
 
 void Settings::check() {
@@ -133,5 +146,6 @@ void Settings::apply() {
     hardware::setLCDBacklight(backlight);
 #endif
 //    hardware::setExternalTemperatueOutput(externT);
+    SerialCommand::begin();
 }
 
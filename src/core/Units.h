@@ -0,0 +1,160 @@
+/*
+    cheali-charger - open source firmware for a variety of LiPo chargers
+    Copyright (C) 2013  Paweł Stawicki. All right reserved.
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#ifndef UNITS_H_
+#define UNITS_H_
+
+#include "AnalogInputsTypes.h"
+#include "Utils.h"
+
+// Fixed-point physical quantities checked at compile time.
+// A Quantity is an unsigned integer counting 10^exponent of a unit
+// volt^V * ampere^A * hour^H, with a known upper bound of Bits bits.
+// Products and quotients get their unit and the narrowest integer that
+// holds the result. The units are checked at compile time only, the
+// operations are the integer ones, except that rescaling to a coarser unit
+// uses Utils::divide (a multiply and shifts, see Utils::mulHigh32) instead
+// of "/": this is not the same code as uint32_t arithmetic with "/".
+namespace Units
+{
+    template<int8_t V, int8_t A, int8_t H, int8_t Exponent>
+    struct Unit {
+        static const int8_t volt = V, amp = A, hour = H, exponent = Exponent;
+    };
+
+    //units of AnalogInputs::ValueType, see ANALOG_VOLT, ANALOG_AMP, ...
+    typedef Unit<1, 0, 0, -3>  Millivolt;
+    typedef Unit<0, 1, 0, -3>  Milliamp;
+    typedef Unit<1, 1, 0, -2>  Centiwatt;
+    typedef Unit<0, 1, 1, -3>  MilliampHour;
+    typedef Unit<1, 1, 1, -2>  CentiwattHour;
+    typedef Unit<1, -1, 0, -3> Milliohm;
+
+    template<typename U1, typename U2>
+    struct Product { typedef Unit<U1::volt + U2::volt, U1::amp + U2::amp,
+        U1::hour + U2::hour, U1::exponent + U2::exponent> Type; };
+    template<typename U1, typename U2>
+    struct Quotient { typedef Unit<U1::volt - U2::volt, U1::amp - U2::amp,
+        U1::hour - U2::hour, U1::exponent - U2::exponent> Type; };
+
+    template<typename U1, typename U2>
+    struct SameDimension { enum { value = U1::volt == U2::volt
+        && U1::amp == U2::amp && U1::hour == U2::hour }; };
+
+    //narrowest integer with Bits bits, wider than 32 bits does not compile
+    template<uint8_t Bits, uint8_t fits = (Bits <= 8) + (Bits <= 16) + (Bits <= 32)>
+    struct Storage;
+    template<uint8_t Bits> struct Storage<Bits, 3> { typedef uint8_t Type; };
+    template<uint8_t Bits> struct Storage<Bits, 2> { typedef uint16_t Type; };
+    template<uint8_t Bits> struct Storage<Bits, 1> { typedef uint32_t Type; };
+
+    template<uint8_t N> struct Pow10 { enum { value = 10 * Pow10<N - 1>::value }; };
+    template<> struct Pow10<0> { enum { value = 1 }; };
+
+    template<typename U, uint8_t Bits = 16>
+    class Quantity {
+    public:
+        typedef U Unit;
+        typedef typename Storage<Bits>::Type Type;
+        enum { bits = Bits };
+
+        Quantity() : value_(0) {}
+        explicit Quantity(Type value) : value_(value) {}
+        Type raw() const { return value_; }
+
+        Quantity &operator+=(Quantity q) { value_ += q.value_; return *this; }
+        Quantity &operator-=(Quantity q) { value_ -= q.value_; return *this; }
+        bool operator<(Quantity q) const { return value_ < q.value_; }
+        bool operator>(Quantity q) const { return value_ > q.value_; }
+        bool operator==(Quantity q) const { return value_ == q.value_; }
+        bool operator!=(Quantity q) const { return value_ != q.value_; }
+    private:
+        Type value_;
+    };
+
+    typedef Quantity<Millivolt>     Voltage;
+    typedef Quantity<Milliamp>      Current;
+    typedef Quantity<Centiwatt>     Power;
+    typedef Quantity<MilliampHour>  Charge;
+    typedef Quantity<CentiwattHour> Energy;
+    typedef Quantity<Milliohm>      Resistance;
+
+    //the ANALOG_* macros must agree with the units above
+    STATIC_ASSERT(ANALOG_VOLT(1) == Pow10<3>::value);
+    STATIC_ASSERT(ANALOG_AMP(1) == Pow10<3>::value);
+    STATIC_ASSERT(ANALOG_WATT(1) == Pow10<2>::value);
+    STATIC_ASSERT(ANALOG_CHARGE(1) == Pow10<3>::value);
+    STATIC_ASSERT(ANALOG_WATTH(1) == Pow10<2>::value);
+    STATIC_ASSERT(ANALOG_OHM(1) == Pow10<3>::value);
+
+    template<typename U1, uint8_t B1, typename U2, uint8_t B2>
+    inline Quantity<typename Product<U1, U2>::Type, B1 + B2>
+    operator*(Quantity<U1, B1> a, Quantity<U2, B2> b) {
+        typedef Quantity<typename Product<U1, U2>::Type, B1 + B2> R;
+        return R(typename R::Type(a.raw()) * b.raw());
+    }
+
+    //b must not be 0, the quotient is bounded by a
+    template<typename U1, uint8_t B1, typename U2, uint8_t B2>
+    inline Quantity<typename Quotient<U1, U2>::Type, B1>
+    operator/(Quantity<U1, B1> a, Quantity<U2, B2> b) {
+        typedef Quantity<typename Quotient<U1, U2>::Type, B1> R;
+        return R(a.raw() / b.raw());
+    }
+
+    //change the exponent: a finer unit multiplies, a coarser one divides
+    template<typename Q, int8_t Exponent, bool finer = (Q::Unit::exponent > Exponent)>
+    struct Rescale;
+
+    template<typename Q, int8_t Exponent>
+    struct Rescale<Q, Exponent, true> {
+        enum { factor = Pow10<Q::Unit::exponent - Exponent>::value };
+        typedef Quantity<Unit<Q::Unit::volt, Q::Unit::amp, Q::Unit::hour, Exponent>,
+            Q::bits + Utils::CeilLog2<factor>::value> Type;
+        static Type apply(Q q) { return Type(typename Type::Type(q.raw()) * factor); }
+    };
+
+    template<typename Q, int8_t Exponent>
+    struct Rescale<Q, Exponent, false> {
+        enum { divisor = Pow10<Exponent - Q::Unit::exponent>::value };
+        typedef Quantity<Unit<Q::Unit::volt, Q::Unit::amp, Q::Unit::hour, Exponent>,
+            Q::bits + 1 - Utils::CeilLog2<divisor + 1>::value> Type;
+        static Type apply(Q q) { return Type(Utils::divide<divisor>(q.raw())); }
+    };
+
+    template<int8_t Exponent, typename Q>
+    inline typename Rescale<Q, Exponent>::Type rescale(Q q) {
+        return Rescale<Q, Exponent>::apply(q);
+    }
+
+    //rescale to a unit of the same dimension, e.g. convert<Centiwatt>(mA * mV)
+    template<typename To, typename Q>
+    inline typename Rescale<Q, To::exponent>::Type convert(Q q) {
+        STATIC_ASSERT((SameDimension<To, typename Q::Unit>::value));
+        return Rescale<Q, To::exponent>::apply(q);
+    }
+
+    //clamp to a 16 bit AnalogInputs::ValueType
+    template<typename U, uint8_t B>
+    inline Quantity<U> saturate(Quantity<U, B> q) {
+        if(B > 16 && q.raw() > 0xffff)
+            return Quantity<U>(0xffff);
+        return Quantity<U>(q.raw());
+    }
+}
+
+#endif /* UNITS_H_ */
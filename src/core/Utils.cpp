@@ -59,6 +59,51 @@ bool testTintern(bool &more, AnalogInputs::ValueType off, AnalogInputs::ValueTyp
     return retu;
 }
 
+namespace {
+    const uint32_t powersOf10[] PROGMEM = {
+        1, 10, 100, 1000, 10000, 100000,
+        1000000, 10000000, 100000000, 1000000000
+    };
+}
+
+uint32_t pow10Long(uint8_t n)
+{
+    return pgm::read(&powersOf10[n]);
+}
+
+namespace {
+    uint8_t ceilLog2(uint16_t d) {
+        uint8_t l = 0;
+        while(((uint32_t)1 << l) < d)
+            l++;
+        return l;
+    }
+}
+
+//d > 0
+void Utils::Divisor16::set(uint16_t d)
+{
+    uint8_t l = ceilLog2(d);
+    m_ = ((uint32_t)1 << 16) * (((uint32_t)1 << l) - d) / d + 1;
+    s1_ = l > 0 ? 1 : 0;
+    s2_ = l > 0 ? l - 1 : 0;
+}
+
+namespace {
+    //one entry per nibble
+    const uint16_t crc16Table[16] PROGMEM = {
+        0x0000, 0xcc01, 0xd801, 0x1400, 0xf001, 0x3c00, 0x2800, 0xe401,
+        0xa001, 0x6c00, 0x7800, 0xb401, 0x5000, 0x9c01, 0x8801, 0x4400
+    };
+}
+
+uint16_t Utils::crc16Update(uint16_t crc, uint8_t a)
+{
+    crc = (crc >> 4) ^ pgm::read(&crc16Table[(crc ^ a) & 0xf]);
+    crc = (crc >> 4) ^ pgm::read(&crc16Table[(crc ^ (a >> 4)) & 0xf]);
+    return crc;
+}
+
 uint16_t pow10(uint8_t n)
 {
     uint16_t retu = 1;
@@ -92,14 +137,15 @@ uint8_t digits(uint16_t x)
 
 uint8_t digits(int32_t x)
 {
-    uint8_t retu = 0;
-    if(x < 0) {
-        retu++;
-        x = -x;
-    }
-    if(x == 0)
-        retu=1;
-    for(;x!=0; x/=10)
+    if(x < 0)
+        return digitsUnsigned(-(uint32_t)x) + 1;
+    return digitsUnsigned(x);
+}
+
+uint8_t digitsUnsigned(uint32_t x)
+{
+    uint8_t retu = 1;
+    while(retu < sizeOfArray(powersOf10) && x >= pow10Long(retu))
         retu++;
     return retu;
 }
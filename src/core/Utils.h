@@ -52,8 +52,10 @@ void callVoidMethod(const VoidMethod method);
 
 bool testTintern(bool &more, AnalogInputs::ValueType off, AnalogInputs::ValueType on);
 uint16_t pow10(uint8_t n);
+uint32_t pow10Long(uint8_t n);
 uint8_t digits(int32_t x);
 uint8_t digits(uint16_t x);
+uint8_t digitsUnsigned(uint32_t x);
 int8_t sign(int16_t x);
 uint8_t countBits(uint16_t v);
 
@@ -69,6 +71,56 @@ uint8_t countElements(const void * const array[]);
 template<typename T>
 uint8_t countElements(const T array[]) {return countElements((const void * const *)array); }
 
+// Division without a divide instruction (the atmega32 and the cortex-m0 have none):
+// x/d = (q + ((x - q) >> s1)) >> s2, q = x*m >> bits (Granlund, Montgomery,
+// "Division by invariant integers using multiplication"), exact for all x.
+namespace Utils
+{
+    template<uint32_t D, uint8_t L = 0, bool done = (D <= (1ULL << L))>
+    struct CeilLog2 { enum { value = CeilLog2<D, L + 1>::value }; };
+    template<uint32_t D, uint8_t L>
+    struct CeilLog2<D, L, true> { enum { value = L }; };
+
+    //(a*b) >> 32 from four 16x16->32 products: a uint64_t product would call
+    //the 64x64 bit __muldi3 (avr) or __aeabi_lmul (cortex-m0 has no UMULL)
+    inline uint32_t mulHigh32(uint32_t a, uint32_t b) {
+        uint16_t al = a, ah = a >> 16;
+        uint16_t bl = b, bh = b >> 16;
+        uint32_t lh = (uint32_t)al * bh;
+        uint32_t hl = (uint32_t)ah * bl;
+        uint32_t mid = (((uint32_t)al * bl) >> 16) + (uint16_t)lh + (uint16_t)hl;
+        return (uint32_t)ah * bh + (lh >> 16) + (hl >> 16) + (mid >> 16);
+    }
+
+    //x/D for a constant D, the multiplier is computed by the compiler
+    template<uint32_t D>
+    inline uint32_t divide(uint32_t x) {
+        STATIC_ASSERT(D > 0);
+        const uint8_t l = CeilLog2<D>::value;
+        if((D & (D - 1)) == 0)
+            return x >> l;
+        const uint32_t m = (((uint64_t)1 << 32) * (((uint64_t)1 << l) - D)) / D + 1;
+        uint32_t q = mulHigh32(x, m);
+        return (q + ((x - q) >> 1)) >> (l > 0 ? l - 1 : 0);
+    }
+
+    //x/d for a divisor known at run time, set() divides once
+    class Divisor16 {
+    public:
+        void set(uint16_t d);
+        uint16_t divide(uint16_t x) const {
+            uint16_t q = ((uint32_t)x * m_) >> 16;
+            return (q + ((x - q) >> s1_)) >> s2_;
+        }
+    private:
+        uint16_t m_;
+        uint8_t s1_, s2_;
+    };
+
+    //CRC-16 (polynomial 0xA001) with one more byte: eeprom data, SessionJournal records
+    uint16_t crc16Update(uint16_t crc, uint8_t a);
+}
+
 // Platform specific delays. Implemented in Utils.cpp located in platform folder
 namespace Utils
 {
@@ -0,0 +1,52 @@
+/*
+    cheali-charger - open source firmware for a variety of LiPo chargers
+    Copyright (C) 2013  Paweł Stawicki. All right reserved.
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "BootInfo.h"
+#include "Time.h"
+#include "SerialLog.h"
+#include "memory.h"
+
+#ifdef ENABLE_BOOT_INFO
+
+namespace BootInfo {
+    uint16_t time_[LAST_PHASE];
+
+    void mark(Phase phase) {
+        time_[phase] = Time::getMilisecondsU16();
+    }
+
+    void report() {
+#ifdef ENABLE_SERIAL_LOG_BB3
+        //the BB3 takes only SCPI commands, show it on its display
+        SerialLog::printString_P(PSTR("DISP:TEXT 'boot"));
+        const char separator = ' ';
+#else
+        SerialLog::printString_P(PSTR("#B"));
+        const char separator = ';';
+#endif
+        for(uint8_t i = 0; i < LAST_PHASE; i++) {
+            SerialLog::printChar(separator);
+            SerialLog::printUInt(time_[i]);
+        }
+#ifdef ENABLE_SERIAL_LOG_BB3
+        SerialLog::printChar('\'');
+#endif
+        SerialLog::printNL();
+    }
+} //namespace BootInfo
+
+#endif //ENABLE_BOOT_INFO
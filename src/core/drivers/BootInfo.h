@@ -0,0 +1,46 @@
+/*
+    cheali-charger - open source firmware for a variety of LiPo chargers
+    Copyright (C) 2013  Paweł Stawicki. All right reserved.
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#ifndef BOOTINFO_H_
+#define BOOTINFO_H_
+
+#include <stdint.h>
+#include "GlobalConfig.h"
+
+/*
+ * boot phase timestamps (Time::getMilisecondsU16() at the end of each phase),
+ * Time starts counting in Time::initialize(), the LCD power up wait in
+ * hardware::initialize() is not included
+ */
+namespace BootInfo {
+    enum Phase { Init, Screen, Settings, Ready, Welcome, LAST_PHASE };
+
+#ifdef ENABLE_BOOT_INFO
+    void mark(Phase phase);
+    //"#B;<Init>;<Screen>;<Settings>;<Ready>;<Welcome>" on the serial port,
+    //Ready is after eeprom::check(), Welcome is the end of the welcome screen
+    //(a key press or a serial command ends it early), with ENABLE_SERIAL_LOG_BB3:
+    //"DISP:TEXT 'boot <Init> <Screen> <Settings> <Ready> <Welcome>'"
+    void report();
+#else
+    inline void mark(Phase phase) {}
+    inline void report() {}
+#endif
+} //namespace BootInfo
+
+
+#endif /* BOOTINFO_H_ */
@@ -0,0 +1,131 @@
+/*
+    cheali-charger - open source firmware for a variety of LiPo chargers
+    Copyright (C) 2013  Paweł Stawicki. All right reserved.
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#define __STDC_LIMIT_MACROS
+#include <stdint.h>
+
+#include "IsrProfiler.h"
+
+#ifdef ENABLE_ISR_PROFILER
+
+#include "ProfilerClock.h"
+#include "SerialLog.h"
+#include "Time.h"
+#include "atomic.h"
+
+namespace IsrProfiler {
+    struct Stats {
+        uint32_t entry;
+        uint32_t durationSum;
+        uint32_t durationMin, durationMax;
+        uint32_t periodMin, periodMax;
+        uint16_t count;
+        bool started;
+    };
+
+    Stats stats_[LAST_SOURCE];
+    //the report interval is counted in Time interrupts, elapsed() handles
+    //only one wrap of the profiler clock (atmega32 Timer1: 2.1s at 16MHz)
+    uint32_t reportInterrupts_;
+
+    uint32_t elapsed(uint32_t from, uint32_t to) {
+#if PROFILER_CLOCK_WRAP
+        if(to < from)
+            return to + (PROFILER_CLOCK_WRAP - from);
+#endif
+        return to - from;
+    }
+
+    void clear(Stats &s) {
+        s.durationSum = 0;
+        s.durationMin = UINT32_MAX;
+        s.durationMax = 0;
+        s.periodMin = UINT32_MAX;
+        s.periodMax = 0;
+        s.count = 0;
+    }
+
+    void initialize() {
+        ProfilerClock::initialize();
+        for(uint8_t i = 0; i < LAST_SOURCE; i++) {
+            clear(stats_[i]);
+            stats_[i].started = false;
+        }
+        reportInterrupts_ = Time::getInterrupts();
+    }
+
+    void begin(Source source) {
+        Stats &s = stats_[source];
+        uint32_t now = ProfilerClock::get();
+        if(s.started) {
+            uint32_t period = elapsed(s.entry, now);
+            if(period < s.periodMin) s.periodMin = period;
+            if(period > s.periodMax) s.periodMax = period;
+        }
+        s.started = true;
+        s.entry = now;
+    }
+
+    void end(Source source) {
+        Stats &s = stats_[source];
+        uint32_t duration = elapsed(s.entry, ProfilerClock::get());
+        if(s.count == UINT16_MAX)
+            return;
+        s.count++;
+        s.durationSum += duration;
+        if(duration < s.durationMin) s.durationMin = duration;
+        if(duration > s.durationMax) s.durationMax = duration;
+    }
+
+    void report() {
+        uint32_t interrupts = Time::getInterrupts();
+        //profiler clock ticks / 1000
+        uint32_t total = (interrupts - reportInterrupts_)
+                * (TIMER_INTERRUPT_PERIOD_MICROSECONDS * PROFILER_CLOCK_TICKS_PER_US) / 1000;
+        uint32_t sleep = 0;
+        reportInterrupts_ = interrupts;
+        for(uint8_t i = 0; i < LAST_SOURCE; i++) {
+            Stats s;
+            ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+                s = stats_[i];
+                clear(stats_[i]);
+            }
+            if(i == Sleep)
+                sleep = s.durationSum;
+            if(s.count == 0)
+                s.durationMin = 0;
+            if(s.periodMin > s.periodMax)
+                s.periodMin = 0;
+            SerialLog::printLong(s.count);
+            SerialLog::printChar(';');
+            SerialLog::printLong(s.durationMin);
+            SerialLog::printChar(';');
+            SerialLog::printLong(s.count ? s.durationSum / s.count : 0);
+            SerialLog::printChar(';');
+            SerialLog::printLong(s.durationMax);
+            SerialLog::printChar(';');
+            SerialLog::printLong(s.periodMin);
+            SerialLog::printChar(';');
+            SerialLog::printLong(s.periodMax);
+            SerialLog::printChar(';');
+        }
+        SerialLog::printLong(total ? sleep / total : 0);
+        SerialLog::printChar(';');
+    }
+} //namespace IsrProfiler
+
+#endif //ENABLE_ISR_PROFILER
@@ -0,0 +1,61 @@
+/*
+    cheali-charger - open source firmware for a variety of LiPo chargers
+    Copyright (C) 2013  Paweł Stawicki. All right reserved.
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#ifndef ISRPROFILER_H_
+#define ISRPROFILER_H_
+
+#include <stdint.h>
+#include "GlobalConfig.h"
+#include "HardwareConfig.h"
+
+/*
+ * interrupt execution time (entry to exit) and inter-arrival time of the
+ * interrupts, of the main loop (Time::doIdle) and of the CPU sleeps
+ * (Time::sleep), in clock ticks of a free running hardware counter
+ * (see: cpu/ProfilerClock.h), reported on the serial log channel 3
+ */
+namespace IsrProfiler {
+    enum Source { TimerIsr, AdcIsr, UartIsr, PwmIsr, PidIsr, MainLoop, Sleep, LAST_SOURCE };
+
+#ifdef ENABLE_ISR_PROFILER
+    void initialize();
+    void begin(Source source);
+    void end(Source source);
+    //"<count>;<min>;<avg>;<max>;<period min>;<period max>;" for each source,
+    //then "<sleep time per mille>;", the statistics start again after each report
+    void report();
+
+    //begin() now, end() when the scope is left, put it first in the interrupt
+    class Scope {
+    public:
+        Scope(Source source) : source_(source) { begin(source); }
+        ~Scope() { end(source_); }
+    private:
+        Source source_;
+    };
+#else
+    inline void initialize() {}
+    inline void report() {}
+    class Scope {
+    public:
+        Scope(Source source) {}
+    };
+#endif
+} //namespace IsrProfiler
+
+
+#endif /* ISRPROFILER_H_ */
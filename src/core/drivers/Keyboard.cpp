@@ -20,6 +20,7 @@
 #include "Buzzer.h"
 #include "memory.h"
 #include "Utils.h"
+#include "atomic.h"
 //#define ENABLE_DEBUG
 #include "debug.h"
 
@@ -60,6 +61,130 @@ namespace Keyboard {
     }
 }
 
+#ifdef ENABLE_KEYBOARD_INTERRUPT
+
+// the keyboard is sampled every BUTTON_DELAY ms from Time::callback,
+// key changes are queued as events: key | KEY_EVENT_CHANGED,
+// a repeat of the held key (key | state_ << KEY_EVENT_STATE_SHIFT) is kept in
+// one slot, the repeat timing starts again when the repeat is read
+// (like getPressedWithDelay() without ENABLE_KEYBOARD_INTERRUPT)
+
+#define BUTTON_DELAY_TICKS          (BUTTON_DELAY*1000/TIMER_INTERRUPT_PERIOD_MICROSECONDS)
+#define KEY_EVENT_KEY_MASK          0x0f
+#define KEY_EVENT_STATE_SHIFT       4
+#define KEY_EVENT_STATE_MASK        0x07
+#define KEY_EVENT_CHANGED           0x80
+#define KEY_EVENT_NONE              0xff
+#define KEY_EVENT_QUEUE_SIZE        8
+
+STATIC_ASSERT((KEY_EVENT_QUEUE_SIZE & (KEY_EVENT_QUEUE_SIZE - 1)) == 0);
+
+namespace Keyboard {
+    volatile uint8_t events_[KEY_EVENT_QUEUE_SIZE];
+    volatile uint8_t eventsHead_ = 0;
+    volatile uint8_t eventsTail_ = 0;
+    volatile uint8_t repeat_ = KEY_EVENT_NONE;
+
+    //interrupt side of the state machine, state_ and last_key_ follow the events
+    uint8_t ticks_ = BUTTON_DELAY_TICKS;
+    uint8_t sampledKey_ = BUTTON_NONE;
+    uint8_t sampledState_ = 0;
+    uint8_t delay_ = 0;
+
+    void pushEvent(uint8_t event) {
+        uint8_t head = eventsHead_;
+        uint8_t next = (head + 1) & (KEY_EVENT_QUEUE_SIZE - 1);
+        if(next == eventsTail_) {
+            //queue full: the newest event is replaced, the last event is always the current key
+            next = head;
+            head = (head - 1) & (KEY_EVENT_QUEUE_SIZE - 1);
+        }
+        events_[head] = event;
+        eventsHead_ = next;
+    }
+
+    bool isEventPending() {
+        return eventsHead_ != eventsTail_ || repeat_ != KEY_EVENT_NONE;
+    }
+}
+
+void Keyboard::doInterrupt()
+{
+    if(--ticks_)
+        return;
+    ticks_ = BUTTON_DELAY_TICKS;
+
+    uint8_t key = hardware::getKeyPressed();
+    if(sampledKey_ != key) {
+        if(debounce_ == 0) {
+            //key changed, an unread repeat of the previous key is dropped
+            sampledKey_ = key;
+            sampledState_ = 0;
+            inState_ = 0;
+            delay_ = 0;
+            repeat_ = KEY_EVENT_NONE;
+            pushEvent(key | KEY_EVENT_CHANGED);
+            return;
+        }
+        debounce_--;
+    } else {
+        debounce_++;
+    }
+    if(debounce_ > BUTTON_DEBOUNCE_COUNT) {
+        debounce_ = BUTTON_DEBOUNCE_COUNT;
+        //the repeat timing (and the acceleration) waits for the reader
+        if(repeat_ == KEY_EVENT_NONE)
+            delay_++;
+    }
+    if(delay_ <= pgm::read(&stateDelay[sampledState_]))
+        return;
+    delay_ = 0;
+
+    //change state if necessary
+    if(sampledState_ < sizeOfArray(stateDelay) - 1 && key != BUTTON_NONE) {
+        inState_++;
+        if(inState_ >= pgm::read(&stayInState[sampledState_])) {
+            sampledState_ ++;
+            inState_ = 0;
+        }
+    }
+    repeat_ = key | (sampledState_ << KEY_EVENT_STATE_SHIFT);
+}
+
+uint8_t Keyboard::getPressedWithDelay()
+{
+    while(!isEventPending()) {
+        Time::doIdle();
+        if(!isEventPending())
+            Time::sleep();
+    }
+
+    uint8_t event;
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+        //key changes first, a repeat is always newer than the queued changes
+        uint8_t tail = eventsTail_;
+        if(tail != eventsHead_) {
+            event = events_[tail];
+            eventsTail_ = (tail + 1) & (KEY_EVENT_QUEUE_SIZE - 1);
+        } else {
+            event = repeat_;
+            repeat_ = KEY_EVENT_NONE;
+        }
+    }
+
+    uint8_t key = event & KEY_EVENT_KEY_MASK;
+    state_ = (event >> KEY_EVENT_STATE_SHIFT) & KEY_EVENT_STATE_MASK;
+    if(event & KEY_EVENT_CHANGED) {
+        last_key_ = key;
+        if(key != BUTTON_NONE) {
+            Buzzer::soundKeyboard();
+        }
+    }
+    return key;
+}
+
+#else //ENABLE_KEYBOARD_INTERRUPT
+
 uint8_t Keyboard::getPressedWithDelay()
 {
     uint8_t key, delay = 0, currentStateDelay;
@@ -102,3 +227,4 @@ uint8_t Keyboard::getPressedWithDelay()
     return key;
 }
 
+#endif //ENABLE_KEYBOARD_INTERRUPT
@@ -19,6 +19,7 @@
 #define KEYBOARD_H_
 
 #include <stdint.h>
+#include "GlobalConfig.h"
 
 #define BUTTON_NONE        0
 
@@ -32,6 +33,13 @@ namespace Keyboard {
     uint8_t getSpeedFactor();
     uint8_t  getPressedWithDelay();
     bool isLongPressTime();
+
+#ifdef ENABLE_KEYBOARD_INTERRUPT
+    //true if getPressedWithDelay() will return without waiting
+    bool isEventPending();
+    //private - called from Time::callback
+    void doInterrupt();
+#endif
 };
 
 
@@ -22,28 +22,130 @@
 
 using namespace AnalogInputs;
 
+// digits are produced by subtracting powers of ten (no divisions,
+// the atmega32 has no hardware divider)
+char* printULong(uint32_t value, char * buf, uint8_t minDigits) {
+    uint8_t i = digitsUnsigned(value);
+    if(i < minDigits)
+        i = minDigits;
+    while(i--) {
+        uint32_t p = pow10Long(i);
+        char c = '0';
+        while(value >= p) {
+            value -= p;
+            c++;
+        }
+        *(buf++) = c;
+    }
+    *buf = 0;
+    return buf;
+}
+
 char* printLong(int32_t value, char * buf) {
-    char * end;
+    uint32_t v = value;
     if (value < 0) {
         *(buf++)='-';
-        value = -value;
+        v = -v;
     }
-    buf += digits((int32_t)value);
-    *buf = 0;
-    end = buf;
-    buf--;
+    return printULong(v, buf);
+}
+
+#ifdef ENABLE_LCD_FRAMEBUFFER
+
+// all lcdPrint* methods draw into lcdBuffer_, lcdFlush() sends
+// the changed characters to the display (called from Time::doIdle and Time::delay)
+
+#define LCD_CELLS               (LCD_COLUMNS*LCD_LINES)
+#define LCD_ADDRESS_UNKNOWN     0xff
+
+STATIC_ASSERT(LCD_CELLS <= 32);
+
+namespace {
+    char lcdBuffer_[LCD_CELLS];
+    uint32_t lcdDirty_;
+    uint8_t lcdX_, lcdY_;
+    //cell the display will write next (its address counter)
+    uint8_t lcdAddress_ = LCD_ADDRESS_UNKNOWN;
+
+    void lcdPutChar(char c) {
+        if(lcdX_ < LCD_COLUMNS) {
+            uint8_t i = lcdY_ * LCD_COLUMNS + lcdX_;
+            if(lcdBuffer_[i] != c) {
+                lcdBuffer_[i] = c;
+                lcdDirty_ |= ((uint32_t) 1) << i;
+            }
+        }
+        lcdX_++;
+    }
+}
+
+void lcdInitialize()
+{
+    //LiquidCrystal::begin has cleared the display
+    memset(lcdBuffer_, ' ', LCD_CELLS);
+    lcdDirty_ = 0;
+    lcdAddress_ = LCD_ADDRESS_UNKNOWN;
+#ifdef ENABLE_LCD_ASYNC
+    //Time is running, LiquidCrystal::doInterrupt can take over
+    LiquidCrystal::enableQueue();
+#endif
+}
+
+void lcdFlush()
+{
+    uint32_t dirty = lcdDirty_;
+    if(!dirty)
+        return;
+    lcdDirty_ = 0;
+
+    uint8_t i = 0;
     do {
-        *buf = (value%10) + '0';
-        value /= 10;
-        buf--;
-    } while(value);
-    return end;
+        if(dirty & 1) {
+#ifdef ENABLE_LCD_ASYNC
+            //cursor command + character = 4 nibbles
+            if(LiquidCrystal::getQueueFree() < 4) {
+                //display is busy, send the rest on the next flush
+                lcdDirty_ |= dirty << i;
+                return;
+            }
+#endif
+            if(lcdAddress_ != i) {
+                LiquidCrystal::setCursor(i % LCD_COLUMNS, i / LCD_COLUMNS);
+            }
+            LiquidCrystal::write(lcdBuffer_[i]);
+            lcdAddress_ = i + 1;
+            //the display doesn't wrap to the next line
+            if(lcdAddress_ % LCD_COLUMNS == 0)
+                lcdAddress_ = LCD_ADDRESS_UNKNOWN;
+        }
+        dirty >>= 1;
+        i++;
+    } while(dirty);
 }
 
+void lcdSetCursor(uint8_t x, uint8_t y) {
+    if(y >= LCD_LINES) y = LCD_LINES - 1;
+    lcdX_ = x;
+    lcdY_ = y;
+}
+void lcdClear() {
+    lcdSetCursor(0, 0);
+    for(uint8_t y = 0; y < LCD_LINES; y++) {
+        lcdPrintSpaces(LCD_COLUMNS);
+        lcdSetCursor(0, y + 1);
+    }
+    lcdSetCursor(0, 0);
+}
+
+#else
+
 void lcdSetCursor(uint8_t x, uint8_t y) { LiquidCrystal::setCursor(x, y); }
+void lcdClear() { LiquidCrystal::clear(); }
+
+#endif //ENABLE_LCD_FRAMEBUFFER
+
 void lcdSetCursor0_0() { lcdSetCursor(0,0); }
 void lcdSetCursor0_1() { lcdSetCursor(0,1); }
-void lcdClear() { LiquidCrystal::clear(); }
 
 int8_t lcdPrintSpace1() {   return lcdPrintSpaces(1); }
 int8_t lcdPrintSpaces() {   return lcdPrintSpaces(16);}
@@ -118,13 +220,7 @@ void lcdPrintR_P(const char *str, int8_t size)
 }
 
 
-static uint16_t div10(uint16_t div) {
-    if(div <= 100)
-        return 100;
-    return 1000;
-}
-
-void lcdPrintValue_(uint16_t x, int8_t dig, uint16_t div, bool mili, bool minus)
+void lcdPrintValue_(uint16_t x, int8_t dig, uint8_t decimals, bool mili, bool minus)
 {
     char buf[12];
     char *end, *dot_char;
@@ -134,8 +230,7 @@ void lcdPrintValue_(uint16_t x, int8_t dig, uint16_t div, bool mili, bool minus)
 
     if(mili) {
         t = x;
-        t *= 1000;
-        t /= div;
+        t *= pow10(3 - decimals);
         if(minus) {
             t = -t;
         }
@@ -149,20 +244,20 @@ void lcdPrintValue_(uint16_t x, int8_t dig, uint16_t div, bool mili, bool minus)
     }
 
     end = buf;
-
-    t = x / div;
     if(minus) {
         *(end++) = '-';
     }
-    end = printLong(t, end);
-    if(div > 1 && end - buf < dig -1) {
-        dot_char = end;
-        t = x % div;
-        t += div;
-        t *= div10(div);
-        t /= div;
-        printLong(t, end);
-        *dot_char = '.';
+    //x is a fixed point value: print all digits, then insert the dot
+    end = printULong(x, end, decimals + 1);
+    if(decimals) {
+        dot_char = end - decimals;
+        if(dot_char - buf < dig - 1) {
+            for(; end >= dot_char; end--)
+                end[1] = end[0];
+            *dot_char = '.';
+        } else {
+            *dot_char = 0;
+        }
     }
 
     lcdPrintR(buf, dig);
@@ -197,7 +292,11 @@ void lcdPrintChar(char c)
     if(c == '\n') {
         lcdSetCursor0_1();
     } else {
+#ifdef ENABLE_LCD_FRAMEBUFFER
+        lcdPutChar(c);
+#else
         LiquidCrystal::print(c);
+#endif
     }
 }
 
@@ -268,42 +367,48 @@ void lcdPrint_mV(int16_t p, int8_t dig)
     lcdPrintAnalog(p, dig, AnalogInputs::SignedVoltage);
 }
 
+//decimal places of the fixed point units, see AnalogInputsTypes.h
+STATIC_ASSERT(ANALOG_AMP(1.000) == 1000 && ANALOG_VOLT(1.000) == 1000
+        && ANALOG_CHARGE(1.000) == 1000 && ANALOG_OHM(1.000) == 1000
+        && ANALOG_WATT(1.00) == 100 && ANALOG_WATTH(1.00) == 100
+        && ANALOG_CELCIUS(1.00) == 100);
+
 struct UnitsInfo {
-    uint16_t div;
+    uint8_t decimals;
     bool mili;
     const char * symbol;
 };
 static const UnitsInfo unitsInfo[] PROGMEM = {
         // Current
-        {ANALOG_AMP(1.000), true, string_A},
+        {3, true, string_A},
         //Voltage,
-        {ANALOG_VOLT(1.000), false, string_V},
+        {3, false, string_V},
         //Power,
-        {ANALOG_WATT(1.00), false,string_W},
+        {2, false,string_W},
         //Work,
-        {ANALOG_WATTH(1.00), false,string_Wh},
+        {2, false,string_Wh},
         //Temperature,
-        {ANALOG_CELCIUS(1.00), false, string_C},
+        {2, false, string_C},
         //Charge,
-        {ANALOG_CHARGE(1.000), true,string_Ah},
+        {3, true,string_Ah},
         //Resistance,
-        {ANALOG_OHM(1.000), true, string_Ohm},
+        {3, true, string_Ohm},
         //Procent,
-        {1, false, string_procent},
+        {0, false, string_procent},
         //SignedVoltage,
-        {ANALOG_VOLT(1.000), true, string_V},
+        {3, true, string_V},
         //Unsigned
-        {1, false, string_unsigned},
+        {0, false, string_unsigned},
         //TemperatureMinutes,
-        {ANALOG_CELCIUS(1.00), false, string_C_m},
+        {2, false, string_C_m},
         //Minutes
-        {1, false, AnalogInputs::string_minutes},
+        {0, false, AnalogInputs::string_minutes},
         //TimeLimitMinutes,
-        {1, false, AnalogInputs::string_minutes},
+        {0, false, AnalogInputs::string_minutes},
         //YesNo
-        {1, false, NULL},
+        {0, false, NULL},
         //Unknown
-        {1, false, AnalogInputs::string_unknown},
+        {0, false, AnalogInputs::string_unknown},
 };
 
 
@@ -335,7 +440,7 @@ void lcdPrintAnalog(AnalogInputs::ValueType x, int8_t dig, AnalogInputs::Type ty
             }
         }
 
-        lcdPrintValue_(x, (int8_t) dig, pgm::read(&unitsInfo[type].div), pgm::read(&unitsInfo[type].mili), sign);
+        lcdPrintValue_(x, (int8_t) dig, pgm::read(&unitsInfo[type].decimals), pgm::read(&unitsInfo[type].mili), sign);
         lcdPrint_P(symbol);
     }
 }
@@ -373,6 +478,10 @@ void lcdCreateCGRam()
    CGRAM[6] = 0b11111;
    CGRAM[7] = 0b11111;
    LiquidCrystal::createChar(2, CGRAM); //battery full
+#ifdef ENABLE_LCD_FRAMEBUFFER
+   //the address counter points to CGRAM now
+   lcdAddress_ = LCD_ADDRESS_UNKNOWN;
+#endif
 }
 #endif
 
@@ -23,12 +23,21 @@
 #include "AnalogInputs.h"
 #include "Utils.h"
 
+char* printULong(uint32_t value, char * buf, uint8_t minDigits = 1);
 char* printLong(int32_t value, char * buf);
 
 #ifdef ENABLE_LCD_RAM_CG
 void lcdCreateCGRam();
 #endif
 
+#ifdef ENABLE_LCD_FRAMEBUFFER
+void lcdInitialize();
+void lcdFlush();
+#else
+inline void lcdInitialize() {}
+inline void lcdFlush() {}
+#endif
+
 void lcdSetCursor(uint8_t x, uint8_t y);
 void lcdSetCursor0_0();
 void lcdSetCursor0_1();
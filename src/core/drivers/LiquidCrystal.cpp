@@ -39,6 +39,27 @@ namespace LiquidCrystal {
     uint8_t _initialized;
 
     uint8_t _numlines, _currline;
+
+#ifdef ENABLE_LCD_ASYNC
+#ifdef LCD_ENABLE_8BITMODE
+#error "ENABLE_LCD_ASYNC works only in 4 bit mode"
+#endif
+
+// must be a power of 2
+#define LCD_QUEUE_SIZE          32
+#define LCD_QUEUE_RS            0x10
+// clear and home need 1.52ms
+#define LCD_QUEUE_LONG          0x20
+#define LCD_QUEUE_LONG_TICKS    (2000/TIMER_INTERRUPT_PERIOD_MICROSECONDS + 1)
+
+    volatile uint8_t queue_[LCD_QUEUE_SIZE];
+    volatile uint8_t queueHead_, queueTail_;
+    uint8_t waitTicks_;
+    bool async_;
+
+    void push(uint8_t v);
+    void pulseEnableShort();
+#endif
 }
 
 
@@ -166,12 +187,18 @@ void LiquidCrystal::begin(uint8_t cols, uint8_t lines, uint8_t dotsize) {
 void LiquidCrystal::clear()
 {
   command(LCD_CLEARDISPLAY);  // clear display, set cursor position to zero
+#ifdef ENABLE_LCD_ASYNC
+  if(async_) return;
+#endif
   Utils::delayMicroseconds(2000);  // this command takes a long time!
 }
 
 void LiquidCrystal::home()
 {
   command(LCD_RETURNHOME);  // set cursor position to zero
+#ifdef ENABLE_LCD_ASYNC
+  if(async_) return;
+#endif
   Utils::delayMicroseconds(2000);  // this command takes a long time!
 }
 
@@ -263,7 +290,7 @@ inline void LiquidCrystal::command(uint8_t value) {
   send(value, LOW);
 }
 
-inline uint8_t LiquidCrystal::write(uint8_t value) {
+uint8_t LiquidCrystal::write(uint8_t value) {
   send(value, HIGH);
   return 1; // assume sucess
 }
@@ -272,6 +299,18 @@ inline uint8_t LiquidCrystal::write(uint8_t value) {
 
 // write either command or data, with automatic 4/8-bit selection
 void LiquidCrystal::send(uint8_t value, uint8_t mode) {
+#ifdef ENABLE_LCD_ASYNC
+  if(async_) {
+    uint8_t rs = mode ? LCD_QUEUE_RS : 0;
+    uint8_t low = (value & 0xf) | rs;
+    if(mode == LOW && value <= (LCD_CLEARDISPLAY | LCD_RETURNHOME)) {
+        low |= LCD_QUEUE_LONG;
+    }
+    push((value >> 4) | rs);
+    push(low);
+    return;
+  }
+#endif
   IO::digitalWrite(LCD_RS_PIN, mode);
 
   // if there is a RW pin indicated, set it low to Write
@@ -296,6 +335,66 @@ void LiquidCrystal::pulseEnable(void) {
   Utils::delayMicroseconds(100);   // commands need > 37us to settle
 }
 
+#ifdef ENABLE_LCD_ASYNC
+
+void LiquidCrystal::enableQueue()
+{
+    async_ = true;
+}
+
+uint8_t LiquidCrystal::getQueueFree()
+{
+    return (queueTail_ - queueHead_ - 1) & (LCD_QUEUE_SIZE - 1);
+}
+
+void LiquidCrystal::push(uint8_t v)
+{
+    uint8_t head = queueHead_;
+    uint8_t next = (head + 1) & (LCD_QUEUE_SIZE - 1);
+    //queue full: wait for doInterrupt (callers should check getQueueFree),
+    //the delay is also an interrupt point of the host simulation
+    while(next == queueTail_)
+        Utils::delayTenMicroseconds(1);
+    queue_[head] = v;
+    queueHead_ = next;
+}
+
+void LiquidCrystal::pulseEnableShort(void) {
+  IO::digitalWrite(LCD_ENABLE_PIN, HIGH);
+  Utils::delayMicroseconds(1);    // enable pulse must be >450ns
+  IO::digitalWrite(LCD_ENABLE_PIN, LOW);
+  // the next nibble is sent after TIMER_INTERRUPT_PERIOD_MICROSECONDS (> 37us)
+}
+
+//called from Time::callback
+void LiquidCrystal::doInterrupt()
+{
+    if(waitTicks_) {
+        waitTicks_--;
+        return;
+    }
+    uint8_t tail = queueTail_;
+    if(tail == queueHead_)
+        return;
+    uint8_t v = queue_[tail];
+    queueTail_ = (tail + 1) & (LCD_QUEUE_SIZE - 1);
+
+    IO::digitalWrite(LCD_RS_PIN, v & LCD_QUEUE_RS);
+#ifdef LCD_RW_PIN
+    IO::digitalWrite(LCD_RW_PIN, LOW);
+#endif
+    IO::digitalWrite(LCD_D0_PIN, v & 1);
+    IO::digitalWrite(LCD_D1_PIN, v & 2);
+    IO::digitalWrite(LCD_D2_PIN, v & 4);
+    IO::digitalWrite(LCD_D3_PIN, v & 8);
+    pulseEnableShort();
+
+    if(v & LCD_QUEUE_LONG)
+        waitTicks_ = LCD_QUEUE_LONG_TICKS;
+}
+
+#endif //ENABLE_LCD_ASYNC
+
 void LiquidCrystal::write4bits(uint8_t value) {
   IO::digitalWrite(LCD_D0_PIN, value & 1);
   IO::digitalWrite(LCD_D1_PIN, value & 2);
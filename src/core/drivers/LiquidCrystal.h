@@ -21,6 +21,7 @@
 
 #include <stdint.h>
 #include <string.h>
+#include "Hardware.h"
 
 // commands
 #define LCD_CLEARDISPLAY 0x01
@@ -97,6 +98,15 @@ namespace LiquidCrystal {
   uint8_t print(char c);
   uint8_t print(const char buffer[]);
 
+#ifdef ENABLE_LCD_ASYNC
+  // after enableQueue() commands are queued and sent by doInterrupt(),
+  // one nibble per Time::callback() tick
+  void enableQueue();
+  // number of free nibbles in the queue (2 per command/character)
+  uint8_t getQueueFree();
+  void doInterrupt();
+#endif
+
 } //namespace LiquidCrystal
 
 #endif
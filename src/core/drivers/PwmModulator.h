@@ -0,0 +1,72 @@
+/*
+    cheali-charger - open source firmware for a variety of LiPo chargers
+    Copyright (C) 2013  Paweł Stawicki. All right reserved.
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#ifndef PWMMODULATOR_H_
+#define PWMMODULATOR_H_
+
+#include <stdint.h>
+
+/*
+ * PWM with more resolution than the timer: next() is called once per PWM
+ * period with a duty cycle of Precision more bits and returns the compare
+ * value for this period, the average is value / 2^Precision.
+ * Order 1 accumulates the remainder (its error repeats with a period of up to
+ * 2^Precision PWM periods: idle tones at low frequencies), order 2 feeds back
+ * the last two errors, NTF = (1 - z^-1)^2, which moves the error to high
+ * frequencies (the output is then between -1 and +2 steps around the value,
+ * so below 2 timer steps it falls back to order 1: no clipping at 0).
+ */
+template<uint8_t Order, uint8_t Precision>
+class PwmModulator;
+
+template<uint8_t Precision>
+class PwmModulator<1, Precision> {
+public:
+    PwmModulator() : sum_(0) {}
+    uint16_t next(uint16_t value) {
+        sum_ += value;
+        uint16_t y = sum_ >> Precision;
+        sum_ &= (1 << Precision) - 1;
+        return y;
+    }
+private:
+    uint16_t sum_;
+};
+
+template<uint8_t Precision>
+class PwmModulator<2, Precision> {
+public:
+    PwmModulator() : e1_(0), e2_(0) {}
+    //Precision <= 8, value + 2^(Precision+2) must fit into uint16_t
+    uint16_t next(uint16_t value) {
+        if(value < (2 << Precision)) {
+            uint16_t v = value + e1_;
+            e1_ = e2_ = v & ((1 << Precision) - 1);
+            return v >> Precision;
+        }
+        //v = value + 2*e1 - e2, shifted by one step to stay positive
+        uint16_t v = value + (1 << Precision) + 2 * e1_ - e2_;
+        e2_ = e1_;
+        e1_ = v & ((1 << Precision) - 1);
+        uint16_t y = v >> Precision;
+        return y - 1;
+    }
+private:
+    uint8_t e1_, e2_;
+};
+
+#endif /* PWMMODULATOR_H_ */
@@ -0,0 +1,328 @@
+/*
+    cheali-charger - open source firmware for a variety of LiPo chargers
+    Copyright (C) 2013  Paweł Stawicki. All right reserved.
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "Hardware.h"
+#include "SerialCommand.h"
+#include "SerialLog.h"
+#include "Program.h"
+#include "ProgramData.h"
+#include "ProgramMenus.h"
+#include "Monitor.h"
+#include "Settings.h"
+#include "memory.h"
+#include "BootInfo.h"
+
+#ifdef ENABLE_SERIAL_COMMAND
+
+#include "Serial.h"
+
+#define SERIAL_COMMAND_MAX_LINE     16
+#define SERIAL_COMMAND_NO_SLOT      0xff
+
+namespace SerialCommand {
+    enum Error { NoError, UnknownCommand, BadArgument, Busy, NoSlot };
+
+    const uint8_t batteryFields = sizeof(ProgramData::Battery) / sizeof(uint16_t);
+
+    char line_[SERIAL_COMMAND_MAX_LINE + 1];
+    uint8_t length_;
+    bool overflow_;
+    bool received_;
+
+    uint8_t slot_ = SERIAL_COMMAND_NO_SLOT;
+    //the slot selected with "L", the menus may be editing ProgramData::battery
+    //at the same time: it is replaced only by "S" and by the remote start
+    ProgramData::Battery battery_;
+    uint8_t startProgram_ = Program::LAST_PROGRAM_TYPE;
+    bool stop_;
+    bool remoteStart_;
+
+    inline uint16_t * batteryField(uint8_t i) {
+        return ((uint16_t *) &ProgramData::battery) + i;
+    }
+
+    //program running, program data must not be changed
+    bool isBusy() {
+        return Program::programState != Program::Done
+                || startProgram_ != Program::LAST_PROGRAM_TYPE;
+    }
+
+    //"R" reads the running program or the slot selected with "L"
+    const uint16_t * readField(uint8_t i) {
+        if(Program::programState != Program::Done || slot_ == SERIAL_COMMAND_NO_SLOT)
+            return batteryField(i);
+        return ((const uint16_t *) &battery_) + i;
+    }
+
+    //ProgramData works on ProgramData::battery, battery_ is put there
+    //only for the time of one command, the menus never see it
+    void swapIn(ProgramData::Battery &saved) {
+        saved = ProgramData::battery;
+        ProgramData::battery = battery_;
+    }
+
+    void swapOut(const ProgramData::Battery &saved) {
+        battery_ = ProgramData::battery;
+        ProgramData::battery = saved;
+    }
+
+    bool parseInt(const char * &s, int32_t &v) {
+        bool minus = false;
+        if(*s == '-') {
+            minus = true;
+            s++;
+        }
+        if(*s < '0' || *s > '9')
+            return false;
+        v = 0;
+        while(*s >= '0' && *s <= '9') {
+            v = v * 10 + (*s - '0');
+            s++;
+        }
+        if(minus) v = -v;
+        return true;
+    }
+
+    void reply(Error e) {
+        SerialLog::printChar('#');
+        if(e == NoError) {
+            SerialLog::printString_P(PSTR("OK"));
+        } else {
+            SerialLog::printChar('E');
+            SerialLog::printUInt(e);
+        }
+        SerialLog::printNL();
+    }
+
+    void printD() {
+        SerialLog::printChar(';');
+    }
+
+    void printField(uint8_t i) {
+        SerialLog::printString_P(PSTR("#R"));
+        SerialLog::printUInt(i);
+        SerialLog::printChar('=');
+        SerialLog::printUInt(*readField(i));
+        SerialLog::printNL();
+    }
+
+    void printStatus() {
+        SerialLog::printString_P(PSTR("#S;"));
+        SerialLog::printUInt(Program::programState);
+        printD();
+        SerialLog::printUInt(Program::programType);
+        printD();
+        SerialLog::printUInt(slot_);
+        printD();
+        SerialLog::printUInt(AnalogInputs::getRealValue(AnalogInputs::VoutBalancer));
+        printD();
+        SerialLog::printUInt(AnalogInputs::getRealValue(AnalogInputs::Iout));
+        printD();
+        SerialLog::printUInt(AnalogInputs::getRealValue(AnalogInputs::Cout));
+        printD();
+        SerialLog::printLong(Monitor::getTimeSec());
+        SerialLog::printNL();
+    }
+
+    //the whole line is checked before anything is changed
+    Error execute() {
+        const char * s = line_ + 1;
+        int32_t v = 0;
+        int32_t value = 0;
+        ProgramData::Battery saved;
+        bool hasArg = parseInt(s, v);
+        bool hasValue = *s == '=';
+        if(hasValue) {
+            s++;
+            if(!parseInt(s, value)) return BadArgument;
+        }
+        if(*s != 0 || (hasValue && line_[0] != 'W')) return BadArgument;
+        if(hasArg && (line_[0] == '?' || line_[0] == 'B' || line_[0] == 'X' || line_[0] == 'S'))
+            return BadArgument;
+
+        switch(line_[0]) {
+        case '?':
+            printStatus();
+            return NoError;
+        case 'B':
+            BootInfo::report();
+            return NoError;
+        case 'X':
+            stop_ = Program::programState != Program::Done;
+            startProgram_ = Program::LAST_PROGRAM_TYPE;
+            return NoError;
+        case 'L':
+            if(isBusy()) return Busy;
+            if(!hasArg || v < 0 || v >= MAX_PROGRAMS) return BadArgument;
+            slot_ = v;
+            swapIn(saved);
+            ProgramData::loadProgramData(slot_);
+            swapOut(saved);
+            return NoError;
+        case 'S':
+            if(isBusy()) return Busy;
+            if(slot_ == SERIAL_COMMAND_NO_SLOT) return NoSlot;
+            swapIn(saved);
+            ProgramData::saveProgramData(slot_);
+            swapOut(saved);
+            return NoError;
+        case 'R':
+            if(!hasArg) {
+                for(uint8_t i = 0; i < batteryFields; i++)
+                    printField(i);
+                return NoError;
+            }
+            if(v < 0 || v >= batteryFields) return BadArgument;
+            printField(v);
+            return NoError;
+        case 'W':
+            if(isBusy()) return Busy;
+            if(slot_ == SERIAL_COMMAND_NO_SLOT) return NoSlot;
+            if(!hasArg || !hasValue || v < 0 || v >= batteryFields) return BadArgument;
+            if(value < INT16_MIN || value > UINT16_MAX) return BadArgument;
+            swapIn(saved);
+            *batteryField(v) = value;
+            if(v == 0) {
+                if(ProgramData::battery.type >= ProgramData::LAST_BATTERY_TYPE)
+                    ProgramData::battery.type = ProgramData::NoneBatteryType;
+                ProgramData::changedType();
+            }
+            ProgramData::check();
+            swapOut(saved);
+            return NoError;
+        case 'P': {
+            bool available;
+            if(isBusy()) return Busy;
+            if(slot_ == SERIAL_COMMAND_NO_SLOT) return NoSlot;
+            if(!hasArg || v < 0) return BadArgument;
+            //the menu depends on the battery type of the remote slot
+            swapIn(saved);
+            available = ProgramMenus::isAvailable((Program::ProgramType)v);
+            swapOut(saved);
+            if(!available) return BadArgument;
+            stop_ = false;
+            startProgram_ = v;
+            return NoError;
+        }
+        default:
+            return UnknownCommand;
+        }
+    }
+
+    void processChar(char c) {
+        if(c == '\r' || c == '\n') {
+            if(length_ > 0) {
+                received_ = true;
+                if(overflow_) {
+                    reply(BadArgument);
+                } else {
+                    line_[length_] = 0;
+                    Error e = execute();
+                    if(e != NoError || (line_[0] != '?' && line_[0] != 'B' && line_[0] != 'R'))
+                        reply(e);
+                }
+            }
+            length_ = 0;
+            overflow_ = false;
+            return;
+        }
+        if(length_ < SERIAL_COMMAND_MAX_LINE) {
+            line_[length_++] = c;
+        } else {
+            overflow_ = true;
+        }
+    }
+
+} // namespace SerialCommand
+
+
+bool SerialCommand::keepOpen()
+{
+    if(settings.UART == Settings::Disabled)
+        return false;
+#ifdef ENABLE_EXT_TEMP_AND_UART_COMMON_OUTPUT
+    //the external temperature input may be needed between programs
+    if(settings.UARToutput == Settings::TempOutput)
+        return false;
+#endif
+    return true;
+}
+
+void SerialCommand::begin()
+{
+    if(keepOpen())
+        Serial::begin(settings.getUARTspeed());
+    else
+        Serial::end();
+    length_ = 0;
+    overflow_ = false;
+}
+
+void SerialCommand::doIdle()
+{
+    //commands are executed only from here, never from an interrupt,
+    //at most one line per call so the idle loop stays short
+    int c;
+    while((c = Serial::read()) >= 0) {
+        processChar(c);
+        if(length_ == 0)
+            break;
+    }
+}
+
+bool SerialCommand::isStartPending()
+{
+    return startProgram_ != Program::LAST_PROGRAM_TYPE;
+}
+
+bool SerialCommand::takeStart(uint8_t &programType)
+{
+    if(!isStartPending())
+        return false;
+    programType = startProgram_;
+    startProgram_ = Program::LAST_PROGRAM_TYPE;
+    ProgramData::battery = battery_;
+    remoteStart_ = true;
+    return true;
+}
+
+bool SerialCommand::takeStop()
+{
+    bool stop = stop_;
+    stop_ = false;
+    return stop;
+}
+
+bool SerialCommand::takeReceived()
+{
+    bool received = received_;
+    received_ = false;
+    return received;
+}
+
+bool SerialCommand::isRemoteStart()
+{
+    return remoteStart_;
+}
+
+void SerialCommand::endRemoteStart()
+{
+    remoteStart_ = false;
+    stop_ = false;
+}
+
+#endif //ENABLE_SERIAL_COMMAND
@@ -0,0 +1,78 @@
+/*
+    cheali-charger - open source firmware for a variety of LiPo chargers
+    Copyright (C) 2013  Paweł Stawicki. All right reserved.
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#ifndef SERIALCOMMAND_H_
+#define SERIALCOMMAND_H_
+
+#include <stdint.h>
+#include "Hardware.h"
+
+/*
+ * line based command interface on the receive side of the serial port,
+ * every command is one line (terminated with '\r' or '\n'):
+ *
+ *  ?               status: "#S;<state>;<program>;<slot>;<Vout>;<Iout>;<Cout>;<time>"
+ *  L<slot>         load program slot (0..MAX_PROGRAMS-1) into the remote copy
+ *  S               save the remote copy into the loaded slot
+ *  R               read all fields of the remote copy (the running program)
+ *  R<field>        read one field: "#R<field>=<value>"
+ *  W<field>=<v>    write one field of the remote copy (ProgramData::check() is applied)
+ *  P<program>      start Program::ProgramType <program> on the remote copy
+ *  X               stop the running program (same as the stop button)
+ *  B               boot phase times, see: BootInfo.h
+ *
+ * replies start with '#' so they do not mix with "$" SerialLog frames,
+ * "#OK" or "#E<error>" is sent for commands without data and for every error,
+ * a line is checked completely before it is executed.
+ * The remote copy is separate from ProgramData::battery (edited in the menus),
+ * it becomes ProgramData::battery only when the program is started.
+ */
+namespace SerialCommand {
+#ifdef ENABLE_SERIAL_COMMAND
+    void doIdle();
+
+    //(re)open the serial port according to the settings
+    void begin();
+    //SerialLog must not close the serial port
+    bool keepOpen();
+
+    //used by MainMenu/Strategy, "take" clears the request
+    bool isStartPending();
+    bool takeStart(uint8_t &programType);
+    bool takeStop();
+
+    //program was started remotely, no start button confirmation needed
+    bool isRemoteStart();
+    void endRemoteStart();
+
+    //a command line was received since the last call (ends the welcome screen)
+    bool takeReceived();
+#else
+    inline void doIdle() {}
+    inline void begin() {}
+    inline bool keepOpen() { return false; }
+    inline bool isStartPending() { return false; }
+    inline bool takeStart(uint8_t &programType) { return false; }
+    inline bool takeStop() { return false; }
+    inline bool isRemoteStart() { return false; }
+    inline void endRemoteStart() {}
+    inline bool takeReceived() { return false; }
+#endif
+} //namespace SerialCommand
+
+
+#endif /* SERIALCOMMAND_H_ */
@@ -23,12 +23,14 @@
 #include "Version.h"
 #include "TheveninMethod.h"
 #include "StackInfo.h"
+#include "IsrProfiler.h"
 #include "IO.h"
 #include "SerialLog.h"
 #include "AnalogInputsPrivate.h"
 #include "Balancer.h"
 #include "Time.h"
 #include "Screen.h"
+#include "SerialCommand.h"
 
 #ifdef ENABLE_SERIAL_LOG
 #include "Serial.h"
@@ -36,10 +38,8 @@
 
 #include "Monitor.h"
 
-#define BB3
 uint8_t small_delay = 100;
 uint16_t big_delay = 500;
-uint16_t Vtmp;
 uint16_t v;
 
 void LogDebug_run() __attribute__((weak));
@@ -86,7 +86,8 @@ void serialEnd()
 {
 	dlogDeInit();
     Serial::flush();
-    Serial::end();
+    if(!SerialCommand::keepOpen())
+        Serial::end();
 }
 
 void printChar(char c)
@@ -212,6 +213,25 @@ void printLong(int32_t x)
     printString(buf);
 }
 
+//fixed point x/10^decimals with all decimals (4050, 3 -> "4.050"),
+//the digits come from ::printULong() (no divisions), the dot is inserted
+void printFixed(uint32_t x, uint8_t decimals)
+{
+    char buf[13];
+    char *end = ::printULong(x, buf, decimals + 1);
+    char *dot = end - decimals;
+    for(; end >= dot; end--)
+        end[1] = end[0];
+    *dot = '.';
+    printString(buf);
+}
+
+//x/10^6 (uAh -> Ah, uWh -> Wh)
+void printMicro(uint32_t x)
+{
+    printFixed(x, 6);
+}
+
 
 
 void sendHeader(uint16_t channel)
@@ -223,9 +243,13 @@ void sendHeader(uint16_t channel)
     printUInt(Program::programType+1);
     printD();
 
-    printLong(currentTime/1000);   //timestamp
-    printChar('.');
-    printUInt((currentTime/100)%10);   //timestamp
+    //timestamp in seconds with one decimal place
+    char buf[12];
+    char *tenth = ::printULong(currentTime, buf, 4) - 3;
+    tenth[1] = tenth[0];
+    tenth[0] = '.';
+    tenth[2] = 0;
+    printString(buf);
     printD();
 }
 
@@ -238,7 +262,7 @@ void printNL()
 
 void sendEnd()
 {
-	#ifndef BB3
+	#ifndef ENABLE_SERIAL_LOG_BB3
     //checksum
     	printUInt(CRC);
 	#endif
@@ -250,7 +274,7 @@ void sendChannel1()
 
 
 
-#ifndef BB3
+#ifndef ENABLE_SERIAL_LOG_BB3
     sendHeader(1);
 
     //analog inputs
@@ -300,23 +324,23 @@ void sendChannel1()
 
     for(uint8_t i=0;i < 8;i++) {
         AnalogInputs::Name name = pgm::read(&channel1[i]);
+        if(name == AnalogInputs::Cout || name == AnalogInputs::Eout) {
+            printMicro(name == AnalogInputs::Cout ? AnalogInputs::getChargeMicroAh()
+                    : AnalogInputs::getEoutMicroWh());
+            printString(", ");
+            continue;
+        }
         v = AnalogInputs::getRealValue(name);
         if (i==0 || i==1 || i==2 || i==7){
-            Vtmp = v/1000;
-            printUInt(Vtmp);
-            printString(".");
-            v = (v-(Vtmp*1000));
+            printFixed(v, 3);
         }
         else if (i==3 || i==4 || i==6){
-            Vtmp = v/100;
-            printUInt(Vtmp);
-            printString(".");
-            v = (v-(Vtmp*100));
+            printFixed(v, 2);
         }
-        else if(i==5){
-        	v=0;
+        else {
+            //i==5
+            printUInt(0);
         }
-        printUInt(v);
         printString(", ");
     }
 
@@ -324,20 +348,10 @@ void sendChannel1()
 //        printUInt(TheveninMethod::getReadableRthCell(i));
 //        printString(", ");
 //    }
-    v = TheveninMethod::getReadableBattRth();
-    Vtmp = v/1000;
-    printUInt(Vtmp);
-    printString(".");
-    v = (v-(Vtmp*1000));
-    printUInt(v);
+    printFixed(TheveninMethod::getReadableBattRth(), 3);
     printString(", ");
 
-    v = TheveninMethod::getReadableWiresRth();
-    Vtmp = v/1000;
-    printUInt(Vtmp);
-    printString(".");
-    v = (v-(Vtmp*1000));
-    printUInt(v);
+    printFixed(TheveninMethod::getReadableWiresRth(), 3);
     printString(", ");
 
     printUInt(Monitor::getChargeProcent());
@@ -350,7 +364,7 @@ void sendChannel1()
 
 void sendChannel2(bool adc)
 {
-#ifndef BB3
+#ifndef ENABLE_SERIAL_LOG_BB3
     sendHeader(2);
     ANALOG_INPUTS_FOR_ALL(it) {
         if(adc) v = AnalogInputs::getAvrADCValue(it);
@@ -373,7 +387,8 @@ void sendChannel2(bool adc)
 
 void sendChannel3()
 {
-#ifndef BB3
+    //the BB3 takes only SENS:DLOG:TRACE:DATA values, no "$3" frames
+#ifndef ENABLE_SERIAL_LOG_BB3
     sendHeader(3);
 #ifdef    ENABLE_STACK_INFO //ENABLE_SERIAL_LOG
     printUInt(StackInfo::getNeverUsedStackSize());
@@ -381,10 +396,13 @@ void sendChannel3()
     printUInt(StackInfo::getFreeStackSize());
     printD();
 #endif
+    IsrProfiler::report();
     sendEnd();
 #endif
 }
 
+#ifdef ENABLE_SERIAL_LOG_BB3
+
 void dlogInit(){
 	//printString("DISP:TEXT:CLE\r\n");
 	//printString("\r\n");
@@ -568,6 +586,13 @@ void dlogDeInit(){
 	Time::delay(small_delay);
 }
 
+#else //ENABLE_SERIAL_LOG_BB3
+
+void dlogInit(){}
+void dlogDeInit(){}
+
+#endif
+
 void sendTime()
 {
     int uart = settings.UART;
@@ -21,8 +21,17 @@
 #include "Buzzer.h"
 #include "Screen.h"
 #include "SerialLog.h"
+#include "SerialCommand.h"
+#include "LcdPrint.h"
+#include "LiquidCrystal.h"
+#include "Keyboard.h"
+#include "eeprom.h"
+#include "SessionJournal.h"
 #include "AnalogInputsPrivate.h"
 #include "atomic.h"
+#include "Utils.h"
+#include "IsrProfiler.h"
+#include "cpu.h"
 
 //#define ENABLE_DEBUG
 #include "debug.h"
@@ -45,18 +54,34 @@ namespace Time {
     }
 
     void doIdle() {
+        IsrProfiler::Scope profile(IsrProfiler::MainLoop);
+        lcdFlush();
         Monitor::doIdle();
         SerialLog::doIdle();
+        SerialCommand::doIdle();
         Buzzer::doIdle();
         AnalogInputs::doIdle();
+        eeprom::doIdle();
+        SessionJournal::doIdle();
+    }
+
+    void sleep() {
+        IsrProfiler::Scope profile(IsrProfiler::Sleep);
+        cpu::idle();
     }
 
     void callback() {
+        IsrProfiler::Scope profile(IsrProfiler::TimerIsr);
         static uint8_t slowInterval = TIMER_SLOW_INTERRUPT_INTERVAL;
         Time::doInterrupt();
+#ifdef ENABLE_LCD_ASYNC
+        LiquidCrystal::doInterrupt();
+#endif
+#ifdef ENABLE_KEYBOARD_INTERRUPT
+        Keyboard::doInterrupt();
+#endif
         if(--slowInterval == 0){
             slowInterval = TIMER_SLOW_INTERRUPT_INTERVAL;
-            AnalogInputs::doSlowInterrupt();
             Monitor::doSlowInterrupt();
         }
     }
@@ -86,7 +111,7 @@ uint16_t Time::getInterruptsU16() {
 
 
 uint32_t Time::getSeconds() {
-    return getMiliseconds()/1000;
+    return Utils::divide<1000>(getMiliseconds());
 }
 
 uint16_t Time::getSecondsU16() {
@@ -94,14 +119,17 @@ uint16_t Time::getSecondsU16() {
 }
 
 uint16_t Time::getMinutesU16() {
-    return getMiliseconds()/60000;
+    return Utils::divide<60000>(getMiliseconds());
 }
 
 void Time::delay(uint16_t ms)
 {
     uint16_t start = getMilisecondsU16();
 
-    while(diffU16(start, getMilisecondsU16()) < ms) {};
+    lcdFlush();
+    while(diffU16(start, getMilisecondsU16()) < ms) {
+        sleep();
+    }
 }
 
 //warning: this method runs stuff in background,
@@ -110,10 +138,13 @@ void Time::delayDoIdle(uint16_t ms)
 {
     uint16_t start = getMilisecondsU16();
     uint16_t delay;
-    do {
+    while(true) {
         doIdle();
         delay = diffU16(start, getMilisecondsU16());
-    } while (delay < ms);
+        if(delay >= ms)
+            break;
+        sleep();
+    }
 
     LogDebug("delayDoIdle ms:", ms, " delay:", delay);
 }
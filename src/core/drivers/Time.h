@@ -38,6 +38,10 @@ namespace Time {
     //warning: this method runs stuff in background,
     //delay may take significantly longer than "ms"
     void delayDoIdle(uint16_t ms);
+    //run the background tasks once
+    void doIdle();
+    //sleep until the next interrupt (cpu::idle())
+    void sleep();
 
     inline uint16_t diffU16(uint16_t start, uint16_t end) {
         return end - start;
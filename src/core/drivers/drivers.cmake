@@ -1,7 +1,8 @@
 
 set(CORE_SOURCE
-    cprintf.cpp  Blink.cpp  Buzzer.cpp  Keyboard.h     LcdPrint.h    LiquidCrystal.h    PolarityCheck.h    SerialLog.h      Time.cpp
-    cprintf.h    Blink.h    Buzzer.h    Keyboard.cpp   LcdPrint.cpp  LiquidCrystal.cpp  PolarityCheck.cpp  SerialLog.cpp    StackInfo.h  Time.h
+    cprintf.cpp  Blink.cpp  Buzzer.cpp  Keyboard.h     LcdPrint.h    LiquidCrystal.h    PolarityCheck.h    SerialLog.h      Time.cpp     SerialCommand.h     BootInfo.h
+    cprintf.h    Blink.h    Buzzer.h    Keyboard.cpp   LcdPrint.cpp  LiquidCrystal.cpp  PolarityCheck.cpp  SerialLog.cpp    StackInfo.h  Time.h       SerialCommand.cpp   BootInfo.cpp
+    IsrProfiler.h  IsrProfiler.cpp  PwmModulator.h
 )
 
 CHEALI_ADD("CORE_SOURCE_FILES" "${CORE_SOURCE}")
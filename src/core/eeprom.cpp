@@ -21,28 +21,63 @@
 #include "Hardware.h"
 #include "Settings.h"
 #include "memory.h"
+#include "Utils.h"
 #include "Version.h"
 #include "eeprom.h"
 #include "Screen.h"
+#include "Program.h"
 
 #define CHARS_TO_UINT16(x,y) (((y)<< 8) + (x))
 
-#define EEPROM_READ_TRIALS 5
+#define EEPROM_READ_TRIALS 4
+
+#ifdef ENABLE_EEPROM_MIGRATION
+#ifndef ENABLE_EEPROM_CRC
+#error "ENABLE_EEPROM_MIGRATION needs ENABLE_EEPROM_CRC"
+#endif
+
+namespace eeprom {
+    struct MigrationMove {
+        uint8_t from;
+        uint8_t to;
+        uint8_t size;
+    };
+    struct Migration {
+        uint8_t section;
+        uint16_t version;
+        uint8_t recordSize;
+        uint8_t firstMove;
+        uint8_t moves;
+    };
+}
+
+#include "eepromMigration.h"
+
+STATIC_ASSERT(sizeof(AnalogInputs::Calibration) == EEPROM_MIGRATION_CALIBRATION_SIZE
+        && CHEALI_CHARGER_EEPROM_CALIBRATION_VERSION == EEPROM_MIGRATION_CALIBRATION_VERSION);
+STATIC_ASSERT(sizeof(ProgramData::Battery) == EEPROM_MIGRATION_PROGRAMDATA_SIZE
+        && CHEALI_CHARGER_EEPROM_PROGRAMDATA_VERSION == EEPROM_MIGRATION_PROGRAMDATA_VERSION);
+STATIC_ASSERT(sizeof(Settings) == EEPROM_MIGRATION_SETTINGS_SIZE
+        && CHEALI_CHARGER_EEPROM_SETTINGS_VERSION == EEPROM_MIGRATION_SETTINGS_VERSION);
+#endif
 
 namespace eeprom {
     Data data EEMEM;
+    //check() first reads everything once, retries only when something does not match
+    uint8_t readTrials_ = EEPROM_READ_TRIALS;
 
     bool testOrRestore(uint16_t * adr, uint16_t version, bool restore) {
-        uint8_t trials = EEPROM_READ_TRIALS;
+        uint8_t trials = readTrials_;
         if(restore) {
             eeprom::write(adr, version);
         }
-        while(--trials) {
+        while(true) {
             if(eeprom::read(adr) == version)
                 return false;
+            if(--trials == 0)
+                return true;
             Time::delay(100);
         }
-        return true;
     }
 
     uint8_t testOrRestore(uint8_t restore) {
@@ -81,8 +116,18 @@ namespace eeprom {
     }
 
 #ifdef ENABLE_EEPROM_RESTORE_DEFAULT
+#ifdef ENABLE_EEPROM_MIGRATION
+    uint8_t migrate(uint8_t what);
+#else
+    inline uint8_t migrate(uint8_t what) { return what; }
+#endif
+
     bool check() {
+        readTrials_ = 1;
         uint8_t c = testOrRestore(0);
+        readTrials_ = EEPROM_READ_TRIALS;
+        if(c != 0)
+            c = migrate(testOrRestore(0));
         if(c == 0) return true;
         restoreDefault(c);
         return false;
@@ -95,28 +140,101 @@ namespace eeprom {
 #endif
 
 
-#ifdef ENABLE_EEPROM_CRC
+#ifdef ENABLE_EEPROM_WRITE_BEHIND
+
+#define EEPROM_WRITE_BEHIND_DELAY       1000
+#define EEPROM_NOT_PENDING              0xff
+
+    bool settingsPending_ = false;
+    uint8_t programDataPending_ = EEPROM_NOT_PENDING;
+    //ProgramData::battery is reloaded by the menus and SerialCommand before the flush,
+    //the queued slot is read from here (see: readProgramData)
+    ProgramData::Battery pendingBattery_;
+    uint16_t pendingTime_;
 
-    inline uint16_t crc16_update(uint16_t crc, uint8_t a) {
-        uint8_t i;
-        crc ^= a;
-        for (i = 0; i < 8; ++i) {
-            if (crc & 1)
-                crc = (crc >> 1) ^ 0xA001;
-            else
-                crc = (crc >> 1);
+    void flushSettings() {
+        if(!settingsPending_)
+            return;
+        eeprom::write(&data.settings, settings);
+        restoreSettingsCRC();
+        settingsPending_ = false;
+    }
+
+    void flushProgramData() {
+        if(programDataPending_ == EEPROM_NOT_PENDING)
+            return;
+        writeProgramData(programDataPending_, pendingBattery_);
+        programDataPending_ = EEPROM_NOT_PENDING;
+    }
+
+    void writeBehindSettings() {
+        settingsPending_ = true;
+        pendingTime_ = Time::getMilisecondsU16();
+    }
+
+    void writeBehindProgramData(uint8_t index) {
+        if(programDataPending_ != index)
+            flushProgramData();
+        programDataPending_ = index;
+        pendingBattery_ = ProgramData::battery;
+        pendingTime_ = Time::getMilisecondsU16();
+    }
+
+    void readProgramData(uint8_t index, ProgramData::Battery &battery) {
+        if(programDataPending_ == index) {
+            battery = pendingBattery_;
+        } else {
+            eeprom::read(battery, &data.battery[index]);
         }
-        return crc;
     }
 
+    void flush() {
+        flushSettings();
+        flushProgramData();
+    }
+
+    void doIdle() {
+        //eeprom writes block the CPU, don't do them while charging
+        if(Program::programState != Program::Done)
+            return;
+        if(Time::diffU16(pendingTime_, Time::getMilisecondsU16()) < EEPROM_WRITE_BEHIND_DELAY)
+            return;
+        flush();
+    }
+#endif
+
+#ifdef ENABLE_EEPROM_CRC
+
     uint16_t getCRC(uint8_t * adr, uint16_t size) {
         uint16_t crc = 0xffff;
         for(uint16_t i = 0; i < size; i++) {
-            crc = crc16_update(crc, eeprom::read(&adr[i]));
+            crc = Utils::crc16Update(crc, eeprom::read(&adr[i]));
+        }
+        return crc;
+    }
+
+    //the CRC is linear: CRC(old) ^ CRC(new) == CRC of (old ^ new) with a zero
+    //initial value, the bytes in front of "adr" don't change and are skipped
+    uint16_t getCRCDelta(uint8_t * adr, const uint8_t * newData, uint16_t size, uint8_t * end) {
+        uint16_t crc = 0;
+        for(uint16_t i = 0; adr + i < end; i++) {
+            uint8_t d = 0;
+            if(i < size) {
+                d = eeprom::read(&adr[i]) ^ newData[i];
+            }
+            crc = Utils::crc16Update(crc, d);
         }
         return crc;
     }
 
+    void writeProgramData(uint8_t index, const ProgramData::Battery &battery) {
+        uint16_t crc = eeprom::read(&data.batteryCRC);
+        crc ^= getCRCDelta((uint8_t*)&data.battery[index], (const uint8_t*)&battery,
+                sizeof(battery), (uint8_t*)&data.batteryCRC);
+        eeprom::write(&data.battery[index], battery);
+        eeprom::write(&data.batteryCRC, crc);
+    }
+
     bool testOrRestoreCRC(uint8_t * adr, uint16_t size, bool restore) {
         uint16_t CRC = getCRC(adr, size);
         return testOrRestore((uint16_t*)(adr+size),CRC, restore);
@@ -135,4 +253,86 @@ namespace eeprom {
     }
 #endif
 
+#ifdef ENABLE_EEPROM_MIGRATION
+
+    // sections written by an older firmware are converted using the
+    // tables generated from utils/eepromExtractor/layouts.py,
+    // fields that did not exist get their default value
+
+    union MigrationRecord {
+        ProgramData::Battery battery;
+        Settings settings;
+    };
+
+    bool migrateSection(uint8_t section, uint8_t * adr, uint8_t records, uint8_t size,
+            uint16_t * version, uint16_t newVersion) {
+        Migration m;
+        uint16_t stored = eeprom::read(version);
+        uint8_t i = 0;
+        do {
+            if(i == sizeOfArray(migrations))
+                return false;
+            pgm::read(m, &migrations[i++]);
+        } while(m.section != section || m.version != stored);
+
+        //the old data must be intact
+        uint16_t oldSize = m.recordSize * records;
+        if(getCRC(adr, oldSize) != eeprom::read((uint16_t*)(adr + oldSize)))
+            return false;
+
+        //growing records are moved starting from the last one
+        bool backward = size > m.recordSize;
+        for(uint8_t j = 0; j < records; j++) {
+            uint8_t r = backward ? records - 1 - j : j;
+            uint8_t old[EEPROM_MIGRATION_MAX_RECORD];
+            MigrationRecord record;
+
+            for(uint8_t k = 0; k < m.recordSize; k++) {
+                old[k] = eeprom::read(&adr[r * m.recordSize + k]);
+            }
+            if(section == EEPROM_RESTORE_SETTINGS) {
+                record.settings.setDefault();
+            } else {
+                ProgramData::battery.type = ProgramData::NoneBatteryType;
+                ProgramData::changedType();
+                record.battery = ProgramData::battery;
+            }
+            for(uint8_t k = 0; k < m.moves; k++) {
+                MigrationMove move;
+                pgm::read(move, &migrationMoves[m.firstMove + k]);
+                memcpy(((uint8_t*)&record) + move.to, &old[move.from], move.size);
+            }
+            if(section == EEPROM_RESTORE_SETTINGS) {
+                eeprom::write((Settings*)adr, record.settings);
+            } else {
+                eeprom::write(((ProgramData::Battery*)adr) + r, record.battery);
+            }
+        }
+        testOrRestoreCRC(adr, size * records, true);
+        testOrRestore(version, newVersion, true);
+        return true;
+    }
+
+    uint8_t migrate(uint8_t what) {
+        //a section starts at the right address only if everything in front of it is valid
+        if(what & (EEPROM_RESTORE_MAGIC_NUMBER | EEPROM_RESTORE_CALIBRATION))
+            return what;
+
+        if(what & EEPROM_RESTORE_PROGRAM_DATA) {
+            if(!migrateSection(EEPROM_RESTORE_PROGRAM_DATA, (uint8_t*)&data.battery, MAX_PROGRAMS,
+                    sizeof(ProgramData::Battery), &data.programDataVersion, CHEALI_CHARGER_EEPROM_PROGRAMDATA_VERSION))
+                return what;
+            what &= ~EEPROM_RESTORE_PROGRAM_DATA;
+        }
+        if(what & EEPROM_RESTORE_SETTINGS) {
+            if(migrateSection(EEPROM_RESTORE_SETTINGS, (uint8_t*)&data.settings, 1,
+                    sizeof(Settings), &data.settingVersion, CHEALI_CHARGER_EEPROM_SETTINGS_VERSION)) {
+                what &= ~EEPROM_RESTORE_SETTINGS;
+                Settings::load();
+            }
+        }
+        return what;
+    }
+#endif
+
 }
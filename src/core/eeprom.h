@@ -56,10 +56,33 @@ namespace eeprom {
     bool restoreCalibrationCRC(bool restore = true);
     bool restoreProgramDataCRC(bool restore = true);
     bool restoreSettingsCRC(bool restore = true);
+    //writes "battery" to slot "index", batteryCRC is updated without
+    //reading the other slots
+    void writeProgramData(uint8_t index, const ProgramData::Battery &battery = ProgramData::battery);
 #else
     inline bool restoreCalibrationCRC(bool restore = true)  { return false; }
     inline bool restoreProgramDataCRC(bool restore = true)  { return false; }
     inline bool restoreSettingsCRC(bool restore = true)     { return false; }
+    inline void writeProgramData(uint8_t index, const ProgramData::Battery &battery = ProgramData::battery) {
+        eeprom::write(&data.battery[index], battery);
+    }
+#endif
+
+#ifdef ENABLE_EEPROM_WRITE_BEHIND
+    //"settings" is the RAM copy, ProgramData::battery is copied when it is queued,
+    //they are written to eeprom when no program is running
+    void writeBehindSettings();
+    void writeBehindProgramData(uint8_t index);
+    //slot "index", also when its write is still queued (no flush needed)
+    void readProgramData(uint8_t index, ProgramData::Battery &battery);
+    void flush();
+    void doIdle();
+#else
+    inline void readProgramData(uint8_t index, ProgramData::Battery &battery) {
+        eeprom::read(battery, &data.battery[index]);
+    }
+    inline void flush() {}
+    inline void doIdle() {}
 #endif
 
 #ifdef ENABLE_EEPROM_RESTORE_DEFAULT
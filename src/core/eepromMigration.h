@@ -0,0 +1,42 @@
+/*
+    cheali-charger - open source firmware for a variety of LiPo chargers
+    Copyright (C) 2013  Paweł Stawicki. All right reserved.
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+// generated by utils/eepromExtractor/genmigration.py from layouts.py - do not edit
+#ifndef EEPROM_MIGRATION_H_
+#define EEPROM_MIGRATION_H_
+
+#define EEPROM_MIGRATION_CALIBRATION_VERSION 10
+#define EEPROM_MIGRATION_CALIBRATION_SIZE 8
+#define EEPROM_MIGRATION_PROGRAMDATA_VERSION 3
+#define EEPROM_MIGRATION_PROGRAMDATA_SIZE 40
+#define EEPROM_MIGRATION_SETTINGS_VERSION 12
+#define EEPROM_MIGRATION_SETTINGS_SIZE 36
+#define EEPROM_MIGRATION_MAX_RECORD 30
+
+namespace eeprom {
+    //{from, to, size} inside a record
+    const MigrationMove migrationMoves[] PROGMEM = {
+        {0, 0, 18}, //backlight, fanOn, fanTempOn, dischargeTempOff, audioBeep, minIc, maxIc, minId, maxId
+        {18, 22, 12}, //inputVoltageLow, adcNoise, UART, UARTspeed, UARToutput, menuType
+    };
+    //{section, stored version, old record size, first move, moves}
+    const Migration migrations[] PROGMEM = {
+        {EEPROM_RESTORE_SETTINGS, 11, 30, 0, 2},
+    };
+} //namespace eeprom
+
+#endif /* EEPROM_MIGRATION_H_ */
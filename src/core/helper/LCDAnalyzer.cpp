@@ -58,6 +58,7 @@ void run() {
         }
         j+=dir;
         if(j>128-16 - ' ' || j < 1) dir *= -1;
+        lcdFlush();
 
     } while(true);
 }
@@ -22,6 +22,8 @@
 #include "ProgramData.h"
 #include "LcdPrint.h"
 #include "memory.h"
+#include "Program.h"
+#include "SerialCommand.h"
 
 using namespace options;
 
@@ -35,10 +37,20 @@ namespace MainMenu {
         }
     }
 
+    void runRemoteProgram()
+    {
+        uint8_t prog;
+        if(SerialCommand::takeStart(prog)) {
+            Program::run((Program::ProgramType) prog);
+            SerialCommand::endRemoteStart();
+        }
+    }
+
     void run()
     {
         int8_t index = 0;
         while(true) {
+            runRemoteProgram();
             Menu::initialize(MAX_PROGRAMS + 1);
             Menu::printMethod_ = printItem;
             Menu::setIndex(index);
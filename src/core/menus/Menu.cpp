@@ -22,6 +22,7 @@
 #include "Blink.h"
 #include "Utils.h"
 #include "memory.h"
+#include "SerialCommand.h"
 
 namespace Menu {
 
@@ -147,6 +148,9 @@ namespace Menu {
                 return getIndex();
             }
             if(alwaysRefresh) render_ = true;
+            //leave all menus, MainMenu starts the remote program
+            if(SerialCommand::isStartPending())
+                break;
         } while(key != BUTTON_STOP || waitRelease_);
         return MENU_EXIT;
     }
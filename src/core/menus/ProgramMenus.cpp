@@ -143,6 +143,18 @@ namespace ProgramMenus {
     }
 }
 
+bool ProgramMenus::isAvailable(Program::ProgramType prog)
+{
+    const Program::ProgramType * menu = getSelectProgramMenu();
+    Program::ProgramType p;
+    do {
+        p = pgm::read(menu++);
+        if(p == prog)
+            return prog != Program::EditBattery;
+    } while(p != Program::EditBattery);
+    return false;
+}
+
 void ProgramMenus::selectProgram(uint8_t index)
 {
     int8_t i;
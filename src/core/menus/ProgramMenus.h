@@ -19,9 +19,12 @@
 #define PROGRAM_MENUS_H_
 
 #include <stdint.h>
+#include "Program.h"
 
 namespace ProgramMenus {
     void selectProgram(uint8_t index);
+    //program can be run on the current ProgramData::battery
+    bool isAvailable(Program::ProgramType prog);
 };
 
 
@@ -29,6 +29,7 @@
 #include "Monitor.h"
 #include "PolarityCheck.h"
 #include "Utils.h"
+#include "SerialCommand.h"
 
 #include "ScreenPages.h"
 
@@ -37,6 +38,12 @@ namespace Screen {
     uint8_t pageNr_;
     uint8_t keyboardButton;
 
+    //indexes of the visible Pages::pageInfo entries (without the NULL terminator),
+    //rebuilt only when getConditions() changes
+    uint8_t pages_[sizeOfArray(Pages::pageInfo) - 1];
+    uint8_t pagesCount_;
+    uint32_t pagesConditions_;
+
     //see PAGE_PROGRAM
     //see PAGE_BATTERY
     STATIC_ASSERT_MSG(ProgramData::LAST_BATTERY_CLASS == 6 && Program::LAST_PROGRAM_TYPE == 9 + 2, "see ScreenPages.h");
@@ -52,28 +59,36 @@ namespace Screen {
         return c;
     }
 
-    VoidMethod getPage(uint8_t page) {
-        uint8_t i = 0;
-        Pages::PageInfo info;
+    void updatePages() {
         uint32_t condition = getConditions();
-        bool ok;
-        page++;
-        do {
-            info = pgm::read(&Pages::pageInfo[i]);
-            ok = ((info.conditionEnable & condition) > 0) && ((info.conditionDisable & condition) == 0);
-            if(ok) {
-                page--;
+        if(pagesCount_ > 0 && condition == pagesConditions_)
+            return;
+
+        pagesConditions_ = condition;
+        pagesCount_ = 0;
+        for(uint8_t i = 0; i < sizeOfArray(pages_); i++) {
+            uint32_t enable = pgm::read(&Pages::pageInfo[i].conditionEnable);
+            uint32_t disable = pgm::read(&Pages::pageInfo[i].conditionDisable);
+            if((enable & condition) && !(disable & condition)) {
+                pages_[pagesCount_++] = i;
             }
-            i++;
-        } while(page);
-        return info.displayMethod;
+        }
+        if(pageNr_ >= pagesCount_)
+            pageNr_ = pagesCount_ > 0 ? pagesCount_ - 1 : 0;
+    }
+
+    VoidMethod getPage(uint8_t page) {
+        return pgm::read(&Pages::pageInfo[pages_[page]].displayMethod);
     }
 
     void displayPage() {
         Screen::Cycle::storeCycleHistoryInfo();
         Blink::incBlinkTime();
 
-        getPage(pageNr_)();
+        updatePages();
+        //Pages::pageInfo has PAGE_ALWAYS pages, this is only a guard
+        if(pagesCount_ > 0)
+            getPage(pageNr_)();
     }
 
     void displayAnimation();
@@ -88,7 +103,7 @@ void Screen::doStrategy()
         Screen::displayPage();
     }
 
-    if(keyboardButton == BUTTON_INC && getPage(pageNr_ + 1) != NULL ) {
+    if(keyboardButton == BUTTON_INC && pageNr_ + 1 < pagesCount_) {
 #ifdef ENABLE_SCREEN_ANIMATION
         Screen::displayAnimation();
 #endif
@@ -116,6 +131,7 @@ void Screen::initialize() {
 #ifdef SCREEN_START_DELAY_MS
     Time::delay(SCREEN_START_DELAY_MS); //waiting common display charger for display relase
 #endif
+    lcdInitialize();
 #ifdef ENABLE_LCD_RAM_CG
     lcdCreateCGRam();
 #endif
@@ -206,6 +222,24 @@ void Screen::runAskResetEeprom(uint8_t what)
     while (waitButtonPressed() != BUTTON_START);
 }
 
+bool Screen::runAskResumeProgram(uint8_t index)
+{
+    uint8_t key;
+    lcdClear();
+    lcdSetCursor0_0();
+    ProgramData::printProgramData(index);
+    lcdSetCursor0_1();
+    lcdPrint_P(PSTR("resume?      yes"));
+    while(Keyboard::getPressedWithDelay() != BUTTON_NONE);
+    do {
+        key = Keyboard::getPressedWithDelay();
+        //a remote "P" or "X" answers no, MainMenu starts the remote program
+        if(SerialCommand::isStartPending() || SerialCommand::takeStop())
+            return false;
+    } while(key != BUTTON_START && key != BUTTON_STOP);
+    return key == BUTTON_START;
+}
+
 void Screen::displayResettingEeprom()
 {
     displayStrings(PSTR("resetting eeprom"));
@@ -232,10 +266,10 @@ void Screen::runCalibrationError(const char *s, uint8_t error) {
 }
 
 
-void Screen::runWelcomeScreen() {
+void Screen::displayWelcomeScreen() {
     Screen::displayStrings(PSTR( CHEALI_CHARGER_PROJECT_NAME_STRING "\n"
                                 "v" CHEALI_CHARGER_VERSION_STRING));
-    Time::delay(3000);
+    lcdFlush();
 }
 
 void Screen::runNeedForceBalance() {
@@ -32,6 +32,9 @@
    #define SCREEN_EMPTY_CELL_CHAR  '_'
 #endif
 
+//how long the welcome screen is shown, initialization runs in the meantime
+#define SCREEN_WELCOME_DELAY_MS     3000
+
 #define PAGE_NONE 0
 #define PAGE_ALWAYS                 0x7fffffff
 
@@ -57,9 +60,11 @@ namespace Screen {
 
     void displayResettingEeprom();
     void runAskResetEeprom(uint8_t what);
+    //START: yes, STOP or a SerialCommand start/stop: no
+    bool runAskResumeProgram(uint8_t index);
     void runResetEepromDone(uint8_t before, uint8_t after);
     void runNotImplemented();
-    void runWelcomeScreen();
+    void displayWelcomeScreen();
     void runCalibrationError(const char *s, uint8_t error);
 
     void runNeedForceBalance();
@@ -40,6 +40,10 @@ namespace Balancer {
     uint32_t IVtime_;
     AnalogInputs::ValueType V_[MAX_BALANCE_CELLS];
 
+    //calculatePerCell()
+    uint8_t perCellCells_;
+    Utils::Divisor16 perCellDivisor_;
+
     bool isWorking()  {
         if(balance != 0)
             return true;
@@ -236,7 +240,7 @@ Strategy::statusType Balancer::doStrategy()
             startBalacing();
     } else {
         trySaveVon();
-        if(getBalanceTime() > maxBalanceTime) {
+        if(getBalanceTime() > BALANCER_MAX_BALANCE_TIME) {
             setBalance(0);
         }
     }
@@ -274,6 +278,11 @@ AnalogInputs::ValueType Balancer::calculatePerCell(AnalogInputs::ValueType v)
     uint8_t cells = AnalogInputs::getConnectedBalancePortCellsCount();
     if(cells == 0)
         return 0;
-    return v/cells;
+    //the connected cells change rarely
+    if(cells != perCellCells_) {
+        perCellCells_ = cells;
+        perCellDivisor_.set(cells);
+    }
+    return perCellDivisor_.divide(v);
 }
 
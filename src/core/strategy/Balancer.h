@@ -28,12 +28,15 @@
 #define BALANCER_I ANALOG_AMP(0.160) //default 160mA
 #endif
 
+#ifndef BALANCER_MAX_BALANCE_TIME
+#define BALANCER_MAX_BALANCE_TIME 15 //15s
+#endif
+
 
 #include "Strategy.h"
 
 namespace Balancer {
 
-    const static uint16_t maxBalanceTime = 15; //15s
     const static uint16_t balancerStartStableCount = 6; //6*0.7s
 
     extern const Strategy::VTable vtable;
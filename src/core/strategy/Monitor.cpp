@@ -30,6 +30,7 @@
 #include "LcdPrint.h"
 #include "Screen.h"
 #include "TheveninMethod.h"
+#include "SessionJournal.h"
 
 #if defined(ENABLE_FAN) && defined(ENABLE_T_INTERNAL)
 #define MONITOR_T_INTERNAL_FAN
@@ -52,6 +53,13 @@ namespace Monitor {
 
     uint16_t Vout_plus_adcMinLimit_;
     uint16_t Vout_plus_adcMaxLimit_;
+    //hardware::setIoutCutoff(), follows Strategy::maxI
+    AnalogInputs::ValueType Iout_limit_;
+
+    //getChargeProcent(): VvalidEmpty, VCharged, (VCharged - VvalidEmpty)/100
+    uint16_t procentV0_, procentV100_;
+    Utils::Divisor16 procentDivisor_;
+    void setChargeProcentLimits();
 
     void calculateDeltaProcentTimeSec();
 
@@ -92,31 +100,40 @@ uint32_t Monitor::getTimeSec()
 }
 
 uint32_t Monitor::getTotalBalanceTimeSec() {
-    return totalBalanceTime_/1000;
+    return Utils::divide<1000>(totalBalanceTime_);
 }
 
 uint32_t Monitor::getTotalChargeDischargeTimeSec() {
-    return totalChargDischargeTime_/1000;
+    return Utils::divide<1000>(totalChargDischargeTime_);
 }
 
 uint16_t Monitor::getTotalChargeDischargeTimeMin() {
-    return totalChargDischargeTime_/1000/60;
+    return Utils::divide<60000>(totalChargDischargeTime_);
 }
 
 
 
+void Monitor::setChargeProcentLimits()
+{
+    procentV100_ = ProgramData::getVoltage(ProgramData::VCharged);
+    procentV0_ = ProgramData::getVoltage(ProgramData::VvalidEmpty);
+    uint16_t step = 0;
+    if(procentV100_ > procentV0_)
+        step = (procentV100_ - procentV0_) / 100;
+    procentDivisor_.set(step ? step : 1);
+}
+
 uint8_t Monitor::getChargeProcent() {
-    uint16_t v1,v2, v;
-    v2 = ProgramData::getVoltage(ProgramData::VCharged);
-    v1 = ProgramData::getVoltage(ProgramData::VvalidEmpty);
+    uint16_t v;
+    //the limits are fixed while the program runs
+    if(!on_)
+        setChargeProcentLimits();
     v =  AnalogInputs::getRealValue(AnalogInputs::VoutBalancer);
 
-    if(v >= v2) return 99;
-    if(v <= v1) return 0;
-    v-=v1;
-    v2-=v1;
-    v2/=100;
-    v=  v/v2;
+    if(v >= procentV100_) return 99;
+    if(v <= procentV0_) return 0;
+    v -= procentV0_;
+    v = procentDivisor_.divide(v);
     if(v > 99) v=99; //not 101% with isCharge
     return v;
 }
@@ -169,8 +186,13 @@ void Monitor::powerOn()
         }
     }
 
+    Iout_limit_ = Strategy::maxI + ANALOG_AMP(1.000);
+    hardware::setIoutCutoff(Iout_limit_);
+
     isBalancePortConnected = AnalogInputs::isBalancePortConnected();
 
+    setChargeProcentLimits();
+
     startTime_totalTime_ = Time::getSeconds();
     resetAccumulatedMeasurements();
     i_externalError = MONITOR_EXTERNAL_ERROR_NONE;
@@ -188,11 +210,23 @@ void Monitor::resetAccumulatedMeasurements()
     totalChargDischargeTime_ = 0;
 }
 
+void Monitor::restoreAccumulatedMeasurements(uint16_t timeMin, uint16_t chargeDischargeTimeMin)
+{
+    //getTimeSec() wraps around correctly
+    startTime_totalTime_ = Time::getSeconds() - timeMin * 60UL;
+    totalChargDischargeTime_ = chargeDischargeTimeMin * 60000UL;
+}
 
 void Monitor::powerOff()
 {
     startTime_totalTime_ = getTimeSec();
     on_ = false;
+    SessionJournal::stop();
+}
+
+bool Monitor::isPowerOn()
+{
+    return on_;
 }
 
 void Monitor::doSlowInterrupt()
@@ -230,6 +264,10 @@ Strategy::statusType Monitor::run()
         Program::stopReason = string_batteryDisconnected;
         return Strategy::ERROR;
     }
+    if(externalError == MONITOR_EXTERNAL_ERROR_OUTPUT_CURRENT_TO_HIGH) {
+        Program::stopReason = string_outputCurrentToHigh;
+        return Strategy::ERROR;
+    }
 
     if (isBalancePortConnected != AnalogInputs::isBalancePortConnected()) {
         Program::stopReason = string_balancePortDisconnected;
@@ -237,6 +275,11 @@ Strategy::statusType Monitor::run()
     }
 
     AnalogInputs::ValueType i_limit = Strategy::maxI + ANALOG_AMP(1.000);
+    if(i_limit != Iout_limit_) {
+        //maxI was edited
+        Iout_limit_ = i_limit;
+        hardware::setIoutCutoff(i_limit);
+    }
     if (i_limit < AnalogInputs::getIout()) {
         Program::stopReason = string_outputCurrentToHigh;
         return Strategy::ERROR;
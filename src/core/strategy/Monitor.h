@@ -22,6 +22,7 @@
 
 #define MONITOR_EXTERNAL_ERROR_NONE                         0
 #define MONITOR_EXTERNAL_ERROR_BATTERY_DISCONNECTED         1
+#define MONITOR_EXTERNAL_ERROR_OUTPUT_CURRENT_TO_HIGH        2
 
 namespace Monitor {
     extern uint32_t etaDeltaSec;
@@ -32,6 +33,7 @@ namespace Monitor {
     void doIdle();
     void powerOn();
     void powerOff();
+    bool isPowerOn();
 
     uint32_t getTimeSec();
     uint32_t getTotalBalanceTimeSec();
@@ -42,6 +44,8 @@ namespace Monitor {
     uint8_t getChargeProcent();
 
     void resetAccumulatedMeasurements();
+    //resumed program (SessionJournal)
+    void restoreAccumulatedMeasurements(uint16_t timeMin, uint16_t chargeDischargeTimeMin);
 
 
     void doSlowInterrupt();
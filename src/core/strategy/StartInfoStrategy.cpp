@@ -23,6 +23,7 @@
 #include "Settings.h"
 #include "Program.h"
 #include "Utils.h"
+#include "SerialCommand.h"
 
 namespace StartInfoStrategy {
     uint8_t ok_;
@@ -96,6 +97,9 @@ Strategy::statusType StartInfoStrategy::doStrategy()
     if(!balance && !v_out && Keyboard::getLast() == BUTTON_START) {
         ok_++;
     }
+    if(!balance && !v_out && SerialCommand::isRemoteStart()) {
+        return Strategy::COMPLETE;
+    }
     if(ok_ == 2) {
         return Strategy::COMPLETE;
     }
@@ -23,6 +23,7 @@
 #include "Monitor.h"
 #include "AnalogInputs.h"
 #include "Screen.h"
+#include "SerialCommand.h"
 
 #define STRATEGY_DISABLE_OUTPUT_AFTER_SECONDS (3*60)
 
@@ -71,7 +72,7 @@ namespace Strategy {
             if(Time::diffU16(time, Time::getSecondsU16()) > STRATEGY_DISABLE_OUTPUT_AFTER_SECONDS) {
                 AnalogInputs::powerOff();
             }
-        } while(Keyboard::getPressedWithDelay() == BUTTON_NONE);
+        } while(Keyboard::getPressedWithDelay() == BUTTON_NONE && !SerialCommand::takeStop());
 
         Buzzer::soundOff();
     }
@@ -121,6 +122,8 @@ namespace Strategy {
         strategyPowerOn();
         do {
             Screen::keyboardButton =  Keyboard::getPressedWithDelay();
+            if(SerialCommand::takeStop())
+                Screen::keyboardButton = BUTTON_STOP;
             Screen::doStrategy();
 
             if(run) {
@@ -22,15 +22,15 @@
 
 #include "Thevenin.h"
 #include "Utils.h"
+#include "Units.h"
 
 AnalogInputs::ValueType Resistance::getReadableRth()
 {
     if(uI == 0)
         return 0;
-    uint32_t R = abs(iV);
-    R *= ANALOG_VOLT(1.0);
-    R/=uI;
-    return R;
+    Units::Resistance R = Units::saturate(
+            Units::rescale<-6>(Units::Voltage(abs(iV))) / Units::Current(uI));
+    return R.raw();
 }
 
 void Thevenin::init(AnalogInputs::ValueType Vth,AnalogInputs::ValueType Vmax, AnalogInputs::ValueType i, bool charge)
@@ -26,8 +26,12 @@
 #include <string.h>
 #include <inttypes.h>
 #include <avr/interrupt.h>
+#include "HardwareConfig.h"
+#include "IsrProfiler.h"
 
+#ifndef ENABLE_SERIAL_COMMAND
 #define DISABLE_RX
+#endif
 
 #ifndef cbi
 #define cbi(sfr, bit) (_SFR_BYTE(sfr) &= ~_BV(bit))
@@ -75,35 +79,44 @@ struct ring_buffer
   volatile unsigned int tail;
 };
 
+// commands are short lines, the receive buffer can be much smaller
+#ifndef DISABLE_RX
+  #define SERIAL_RX_BUFFER_SIZE 32
+#else
+  #define SERIAL_RX_BUFFER_SIZE 1
+#endif
+
+struct rx_ring_buffer
+{
+  unsigned char buffer[SERIAL_RX_BUFFER_SIZE];
+  volatile unsigned int head;
+  volatile unsigned int tail;
+};
+
 #if defined(USBCON)
-  ring_buffer rx_buffer = { { 0 }, 0, 0};
+  rx_ring_buffer rx_buffer = { { 0 }, 0, 0};
   ring_buffer tx_buffer = { { 0 }, 0, 0};
 #endif
 #if defined(UBRRH) || defined(UBRR0H)
   ring_buffer tx_buffer  =  { { 0 }, 0, 0 };
-#ifndef DISABLE_RX
-  ring_buffer rx_buffer  =  { { 0 }, 0, 0 };
-#else
-  //TODO: change this
-  ring_buffer &rx_buffer = tx_buffer;
-#endif
+  rx_ring_buffer rx_buffer  =  { { 0 }, 0, 0 };
 #endif
 #if defined(UBRR1H)
-  ring_buffer rx_buffer1  =  { { 0 }, 0, 0 };
+  rx_ring_buffer rx_buffer1  =  { { 0 }, 0, 0 };
   ring_buffer tx_buffer1  =  { { 0 }, 0, 0 };
 #endif
 #if defined(UBRR2H)
-  ring_buffer rx_buffer2  =  { { 0 }, 0, 0 };
+  rx_ring_buffer rx_buffer2  =  { { 0 }, 0, 0 };
   ring_buffer tx_buffer2  =  { { 0 }, 0, 0 };
 #endif
 #if defined(UBRR3H)
-  ring_buffer rx_buffer3  =  { { 0 }, 0, 0 };
+  rx_ring_buffer rx_buffer3  =  { { 0 }, 0, 0 };
   ring_buffer tx_buffer3  =  { { 0 }, 0, 0 };
 #endif
 
-inline void store_char(unsigned char c, ring_buffer *buffer)
+inline void store_char(unsigned char c, rx_ring_buffer *buffer)
 {
-  int i = (unsigned int)(buffer->head + 1) % SERIAL_BUFFER_SIZE;
+  int i = (unsigned int)(buffer->head + 1) % SERIAL_RX_BUFFER_SIZE;
 
   // if we should be storing the received character into the location
   // just before the tail (meaning that the head would advance to the
@@ -133,6 +146,7 @@ inline void store_char(unsigned char c, ring_buffer *buffer)
   ISR(USART_RXC_vect) // ATmega8
 #endif
   {
+    IsrProfiler::Scope profile(IsrProfiler::UartIsr);
   #if defined(UDR0)
     if (bit_is_clear(UCSR0A, UPE0)) {
       unsigned char c = UDR0;
@@ -232,6 +246,7 @@ ISR(USART0_UDRE_vect)
 ISR(USART_UDRE_vect)
 #endif
 {
+  IsrProfiler::Scope profile(IsrProfiler::UartIsr);
   if (tx_buffer.head == tx_buffer.tail) {
     // Buffer empty, so disable interrupts
 #if defined(UCSR0B)
@@ -311,7 +326,7 @@ ISR(USART3_UDRE_vect)
 
 // Constructors ////////////////////////////////////////////////////////////////
 
-HardwareSerial::HardwareSerial(ring_buffer *rx_buffer, ring_buffer *tx_buffer,
+HardwareSerial::HardwareSerial(rx_ring_buffer *rx_buffer, ring_buffer *tx_buffer,
   volatile uint8_t *ubrrh, volatile uint8_t *ubrrl,
   volatile uint8_t *ucsra, volatile uint8_t *ucsrb,
   volatile uint8_t *ucsrc, volatile uint8_t *udr,
@@ -448,7 +463,7 @@ void HardwareSerial::end()
 
 int HardwareSerial::available(void)
 {
-  return (unsigned int)(SERIAL_BUFFER_SIZE + _rx_buffer->head - _rx_buffer->tail) % SERIAL_BUFFER_SIZE;
+  return (unsigned int)(SERIAL_RX_BUFFER_SIZE + _rx_buffer->head - _rx_buffer->tail) % SERIAL_RX_BUFFER_SIZE;
 }
 
 int HardwareSerial::peek(void)
@@ -467,7 +482,7 @@ int HardwareSerial::read(void)
     return -1;
   } else {
     unsigned char c = _rx_buffer->buffer[_rx_buffer->tail];
-    _rx_buffer->tail = (unsigned int)(_rx_buffer->tail + 1) % SERIAL_BUFFER_SIZE;
+    _rx_buffer->tail = (unsigned int)(_rx_buffer->tail + 1) % SERIAL_RX_BUFFER_SIZE;
     return c;
   }
 }
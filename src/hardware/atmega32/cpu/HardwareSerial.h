@@ -28,11 +28,12 @@
 #include <avr/io.h>
 
 struct ring_buffer;
+struct rx_ring_buffer;
 
 class HardwareSerial
 {
   private:
-    ring_buffer *_rx_buffer;
+    rx_ring_buffer *_rx_buffer;
     ring_buffer *_tx_buffer;
     volatile uint8_t *_ubrrh;
     volatile uint8_t *_ubrrl;
@@ -47,7 +48,7 @@ class HardwareSerial
     uint8_t _u2x;
     bool transmitting;
   public:
-    HardwareSerial(ring_buffer *rx_buffer, ring_buffer *tx_buffer,
+    HardwareSerial(rx_ring_buffer *rx_buffer, ring_buffer *tx_buffer,
       volatile uint8_t *ubrrh, volatile uint8_t *ubrrl,
       volatile uint8_t *ucsra, volatile uint8_t *ucsrb,
       volatile uint8_t *ucsrc, volatile uint8_t *udr,
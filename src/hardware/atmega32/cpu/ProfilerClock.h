@@ -0,0 +1,46 @@
+/*
+    cheali-charger - open source firmware for a variety of LiPo chargers
+    Copyright (C) 2013  Paweł Stawicki. All right reserved.
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#ifndef PROFILERCLOCK_H_
+#define PROFILERCLOCK_H_
+
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#include "Timer1.h"
+
+//Timer1 counts F_CPU cycles from 0 to TIMER1_PERIOD (fast PWM),
+//its overflows are counted in the TIMER1_OVF interrupt
+#define PROFILER_CLOCK_WRAP (65536UL * (TIMER1_PERIOD + 1))
+#define PROFILER_CLOCK_TICKS_PER_US (F_CPU / 1000000UL)
+
+namespace ProfilerClock {
+    inline void initialize() {}
+
+    inline uint32_t get() {
+        uint8_t sreg = SREG;
+        cli();
+        uint16_t t = TCNT1;
+        uint16_t overflows = Timer1::overflows;
+        //overflow not handled yet (we are in an interrupt)
+        if((TIFR & _BV(TOV1)) && t < TIMER1_PERIOD / 2)
+            overflows++;
+        SREG = sreg;
+        return uint32_t(overflows) * (TIMER1_PERIOD + 1) + t;
+    }
+}
+
+#endif /* PROFILERCLOCK_H_ */
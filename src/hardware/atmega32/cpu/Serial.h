@@ -29,6 +29,7 @@ namespace Serial {
     inline void  flush()                       { Serial0.flush(); }
     inline void  end()                         { Serial0.end(); }
     inline void  initialize()                  {}
+    inline int   read()                        { return Serial0.read(); }
 } // namespace Serial
 
 #endif //  Serial_H_
@@ -4,30 +4,38 @@
 #include "Hardware.h"
 #include "atomic.h"
 #include "IO.h"
+#include "Utils.h"
+#include "PwmModulator.h"
+#include "IsrProfiler.h"
 
 namespace {
     volatile uint16_t Timer1_valueA=0;
     volatile uint16_t Timer1_valueB=0;
-    uint16_t Timer1_sumA=0;
-    uint16_t Timer1_sumB=0;
+    PwmModulator<TIMER1_MODULATOR_ORDER, TIMER1_PRECISION> Timer1_modulatorA;
+    PwmModulator<TIMER1_MODULATOR_ORDER, TIMER1_PRECISION> Timer1_modulatorB;
+
+    STATIC_ASSERT(((TIMER1_PERIOD + 4UL) << TIMER1_PRECISION) <= 0xffff);
 
     void setOCR() {
         //modulate the PWM - we modulate the PWM signal to get more precision.
         //(the PWM frequency stays at about 31kHz)
-        Timer1_sumA+=Timer1_valueA;
-        Timer1_sumB+=Timer1_valueB;
-        ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
-            OCR1A = (Timer1_sumA>>TIMER1_PRECISION);
-            OCR1B = (Timer1_sumB>>TIMER1_PRECISION);
-        }
-        Timer1_sumA&=(1<<TIMER1_PRECISION) - 1;
-        Timer1_sumB&=(1<<TIMER1_PRECISION) - 1;
+        //interrupts are disabled in the ISR, OCR1x use the shared TEMP register
+        OCR1A = Timer1_modulatorA.next(Timer1_valueA);
+        OCR1B = Timer1_modulatorB.next(Timer1_valueB);
     }
 
 }
 
+#ifdef ENABLE_ISR_PROFILER
+volatile uint16_t Timer1::overflows;
+#endif
+
 ISR(TIMER1_OVF_vect)
 {
+#ifdef ENABLE_ISR_PROFILER
+    Timer1::overflows++;
+#endif
+    IsrProfiler::Scope profile(IsrProfiler::PwmIsr);
     setOCR(); //modulate the PWM
 }
 
@@ -3,7 +3,14 @@
 
 #include "HardwareConfig.h"
 
+//duty cycle bits below the timer resolution, see: PwmModulator.h
+#ifndef TIMER1_PRECISION
 #define TIMER1_PRECISION 5
+#endif
+//1: accumulator (idle tones at low duty cycles), 2: noise shaped
+#ifndef TIMER1_MODULATOR_ORDER
+#define TIMER1_MODULATOR_ORDER 2
+#endif
 #define TIMER1_PRECISION_PERIOD (TIMER1_PERIOD<<TIMER1_PRECISION)
 
 namespace Timer1
@@ -11,6 +18,10 @@ namespace Timer1
     void initialize();
     void disablePWM(char pin);
     void setPWM(char pin, unsigned int duty);
+#ifdef ENABLE_ISR_PROFILER
+    //TIMER1_OVF interrupts, see: ProfilerClock.h
+    extern volatile uint16_t overflows;
+#endif
 };
 
 #endif //TIMER_1_H_
@@ -18,12 +18,28 @@
 #include "Time.h"
 #include "Hardware.h"
 #include "atomic.h"
+#ifdef SMPS_PID_PERIOD_US
+#include "SMPS_PID.h"
+#include "IsrProfiler.h"
+#if SMPS_PID_PERIOD_US % TIMER_INTERRUPT_PERIOD_MICROSECONDS
+#error "SMPS_PID_PERIOD_US: not a multiple of TIMER_INTERRUPT_PERIOD_MICROSECONDS"
+#endif
+#endif
 
 
 // time measurement - It uses atmega32/Timer2 to measure TIMER_INTERRUPT_PERIOD_MICROSECONDS
 
 ISR(TIMER2_COMP_vect)
 {
+#ifdef SMPS_PID_PERIOD_US
+    //first: a constant phase to the tick
+    static uint8_t pidTicks;
+    if(++pidTicks >= SMPS_PID_PERIOD_US / TIMER_INTERRUPT_PERIOD_MICROSECONDS) {
+        pidTicks = 0;
+        IsrProfiler::Scope profile(IsrProfiler::PidIsr);
+        SMPS_PID::update();
+    }
+#endif
     Time::callback();
 }
 
@@ -19,11 +19,17 @@
 #define CPU_H_
 
 #include <avr/interrupt.h>
+#include <avr/sleep.h>
 
 namespace cpu {
     inline void init() {
         sei();
     }
+    //sleep until the next interrupt, timers, ADC and UART keep running
+    inline void idle() {
+        set_sleep_mode(SLEEP_MODE_IDLE);
+        sleep_mode();
+    }
 }
 
 #endif /* CPU_H_ */
@@ -167,6 +167,16 @@ namespace eeprom {
     };
 
 
+    //starts writing one changed byte and returns, the write takes 8.5ms,
+    //false: the previous write is not finished, nothing was done
+    inline bool tryUpdateByte(uint8_t * addressE, uint8_t value) {
+        if(!eeprom_is_ready())
+            return false;
+        if(eeprom_read_byte(addressE) != value)
+            eeprom_write_byte(addressE, value);
+        return true;
+    }
+
     template<class Type>
     static Type read(const Type * addressE) {
         return read_impl<Type, sizeof(Type)>() (addressE);
@@ -45,6 +45,8 @@ namespace hardware {
     void setDischargerValue(uint16_t value);
     //200W chargers do not have Vout limit, see also Monitor.cpp
     inline void setVoutCutoff(AnalogInputs::ValueType v){};
+    //no ADC digital comparators, see also Monitor.cpp
+    inline void setIoutCutoff(AnalogInputs::ValueType I){};
 
     void setFan(bool enable);
     void setBalancer(uint8_t balance);
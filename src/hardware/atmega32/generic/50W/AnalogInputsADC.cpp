@@ -27,6 +27,7 @@
 #include "Settings.h"
 #include "Timer0.h"
 #include "AnalogInputsPrivate.h"
+#include "IsrProfiler.h"
 #include "IO.h"
 #include "SMPS.h"
 #include "Discharger.h"
@@ -170,6 +171,7 @@ inline void finalizeMeasurement()
 {
     AnalogInputs::i_adc_[AnalogInputs::IsmpsSet]        = SMPS::getValue();
     AnalogInputs::i_adc_[AnalogInputs::IdischargeSet]   = Discharger::getValue();
+    AnalogInputs::intterruptIntegrate();
     if(g_addSumToInput) {
         AnalogInputs::i_avrSum_[AnalogInputs::IsmpsSet]        += ANALOG_INPUTS_ADC_BURST_COUNT * SMPS::getValue();
         AnalogInputs::i_avrSum_[AnalogInputs::IdischargeSet]   += ANALOG_INPUTS_ADC_BURST_COUNT * Discharger::getValue();
@@ -262,11 +264,13 @@ void conversionDone()
         break;
 
 #endif
+#ifndef SMPS_PID_PERIOD_US
     case ANALOG_INPUTS_ADC_BURST_COUNT-3:
         /* update PID if necessary */
         if(adc_input.ai_name == AnalogInputs::Ismps)
             SMPS_PID::update();
         break;
+#endif
 
 #ifdef ENABLE_ANALOG_INPUTS_ADC_NOISE
     case ANALOG_INPUTS_ADC_BURST_COUNT-2:
@@ -303,6 +307,7 @@ void setupNextInput() {
 
 ISR(ADC_vect)
 {
+    IsrProfiler::Scope profile(IsrProfiler::AdcIsr);
     AnalogInputsADC::conversionDone();
 }
 
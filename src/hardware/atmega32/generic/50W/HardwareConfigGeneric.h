@@ -39,6 +39,8 @@
 #define ENABLE_STACK_INFO
 #define ENABLE_GET_PID_VALUE
 #define ENABLE_EXPERT_VOLTAGE_CALIBRATION
+//SMPS_PID::update() every n-th Timer2 tick (the latest Ismps burst value), default: at the Ismps bursts
+//#define SMPS_PID_PERIOD_US 1000
 
 #define ENABLE_EXT_TEMP_AND_UART_COMMON_OUTPUT
 
@@ -44,6 +44,8 @@ namespace hardware {
     void setChargerValue(uint16_t value);
     void setDischargerValue(uint16_t value);
     void setVoutCutoff(AnalogInputs::ValueType v);
+    //no ADC digital comparators, see also Monitor.cpp
+    inline void setIoutCutoff(AnalogInputs::ValueType I){};
 
     void setBalancer(uint8_t balance);
     void doInterrupt();
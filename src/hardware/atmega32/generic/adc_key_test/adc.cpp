@@ -27,6 +27,7 @@
 #include "IO.h"
 #include "Settings.h"
 #include "AnalogInputsPrivate.h"
+#include "IsrProfiler.h"
 
 //#define ENABLE_DEBUG
 #include "debug.h"
@@ -175,6 +176,7 @@ void finalizeMeasurement()
 {
     AnalogInputs::i_adc_[AnalogInputs::IsmpsSet]        = SMPS::getValue();
     AnalogInputs::i_adc_[AnalogInputs::IdischargeSet]   = Discharger::getValue();
+    AnalogInputs::intterruptIntegrate();
     if(g_addSumToInput) {
         AnalogInputs::i_avrSum_[AnalogInputs::IsmpsSet]        += SMPS::getValue();
         AnalogInputs::i_avrSum_[AnalogInputs::IdischargeSet]   += Discharger::getValue();
@@ -304,5 +306,6 @@ uint8_t hardware::getKeyPressed()
 
 ISR(ADC_vect)
 {
+    IsrProfiler::Scope profile(IsrProfiler::AdcIsr);
     adc::conversionDone();
 }
@@ -0,0 +1,269 @@
+/*
+    cheali-charger - open source firmware for a variety of LiPo chargers
+    Copyright (C) 2013  Paweł Stawicki. All right reserved.
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/*
+ * cheali-battery-batch: charges many randomized packs with a reference
+ * CC/CV (Li, Pb, NiZn) or CC/-dV (NiCd, NiMH) charger, in parallel threads,
+ * and prints a summary. It exercises the battery model, not the firmware:
+ * the charger core has global state, see cheali-charger-simulation.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <getopt.h>
+#include <math.h>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+#include <algorithm>
+
+#include "BatteryModel.h"
+
+namespace {
+
+    //ProgramData::BatteryType
+    enum { NiCd = 1, NiMH = 2, Pb = 3, NiZn = 9 };
+
+    struct Options {
+        BatteryModel::PackConfig pack;
+        unsigned packs;
+        unsigned threads;
+        double current;         //C
+        double dt;              //s
+        double maxTime;         //s
+    } options;
+
+    struct Result {
+        double time;            //s
+        double charge;          //Ah
+        double energy;          //Wh
+        double overshoot;       //V, max cell voltage - Vcharged
+        double spread;          //V, final max - min cell voltage
+        double maxTemperature;  //C
+        bool timeout;
+    };
+
+    bool isNiXX(uint8_t type) {
+        return type == NiCd || type == NiMH;
+    }
+
+    Result charge(uint32_t seed)
+    {
+        BatteryModel::PackConfig config = options.pack;
+        config.seed = seed;
+        BatteryModel::Pack pack;
+        pack.init(config);
+
+        const BatteryModel::Chemistry &chem = pack.getChemistry();
+        const double dt = options.dt;
+        const double Ic = options.current * config.capacity;
+        const double Vmax = chem.Vcharged * config.cells;
+        const double Iend = Ic / (config.batteryType == Pb ? 20 : 10);
+        //-dV: 5mV per cell below the peak, ignored for the first 10 minutes
+        const double deltaV = 0.005 * config.cells;
+        const double deltaVIgnore = 600;
+
+        Result r = Result();
+        double I = Ic, Vpeak = 0;
+        for(r.time = 0; r.time < options.maxTime; r.time += dt) {
+            //constant voltage: the current follows the internal voltage
+            if(!isNiXX(config.batteryType)) {
+                double Icv = (Vmax - pack.getInternalVoltage()) / pack.getResistance();
+                I = std::min(Ic, Icv);
+                if(I < Iend)
+                    break;
+            }
+            pack.step(I, dt);
+            double V = pack.getVoltage();
+            r.charge += I * dt / 3600;
+            r.energy += I * V * dt / 3600;
+            for(uint8_t c = 0; c < pack.getCells(); c++) {
+                const BatteryModel::Cell &cell = pack.getCell(c);
+                r.overshoot = std::max(r.overshoot, cell.getVoltage() - chem.Vcharged);
+                r.maxTemperature = std::max(r.maxTemperature, cell.getTemperature());
+            }
+            if(isNiXX(config.batteryType)) {
+                Vpeak = std::max(Vpeak, V);
+                if(r.time > deltaVIgnore && V < Vpeak - deltaV)
+                    break;
+            }
+        }
+        r.timeout = r.time >= options.maxTime;
+
+        double Vmin = 1e9, Vmax_ = -1e9;
+        for(uint8_t c = 0; c < pack.getCells(); c++) {
+            double v = pack.getCell(c).getInternalVoltage();
+            Vmin = std::min(Vmin, v);
+            Vmax_ = std::max(Vmax_, v);
+        }
+        r.spread = Vmax_ - Vmin;
+        return r;
+    }
+
+    void worker(std::atomic<unsigned> *next, std::vector<Result> *results)
+    {
+        unsigned i;
+        while((i = next->fetch_add(1)) < options.packs)
+            (*results)[i] = charge(options.pack.seed + i);
+    }
+
+    struct Stat {
+        double min, mean, max;
+    };
+
+    Stat stat(const std::vector<Result> &results, double Result::*field)
+    {
+        Stat s = {1e9, 0, -1e9};
+        for(size_t i = 0; i < results.size(); i++) {
+            double v = results[i].*field;
+            s.min = std::min(s.min, v);
+            s.max = std::max(s.max, v);
+            s.mean += v;
+        }
+        s.mean /= results.size();
+        return s;
+    }
+
+    void printStat(const char *name, const Stat &s, double scale)
+    {
+        printf("%-16s %10.3f %10.3f %10.3f\n", name, s.min * scale, s.mean * scale, s.max * scale);
+    }
+
+    bool findChemistry(const char *name, uint8_t &type)
+    {
+        for(uint8_t i = 0; i < BATTERY_MODEL_CHEMISTRIES; i++) {
+            if(strcasecmp(BatteryModel::getChemistry(i).name, name) == 0) {
+                type = i;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void usage(const char *name)
+    {
+        fprintf(stderr, "usage: %s [options]\n"
+            "  -b, --chemistry TYPE     battery type (default Lipo)\n"
+            "  -c, --cells N            cells in series (default 3)\n"
+            "  -C, --capacity MAH       nominal capacity (default 2200)\n"
+            "  -I, --current C          charge current in C (default 1)\n"
+            "  -n, --packs N            number of randomized packs (default 1000)\n"
+            "  -j, --threads N          worker threads (default: hardware concurrency)\n"
+            "      --soc PERCENT        nominal initial state of charge (default 10)\n"
+            "      --capacity-spread PERCENT, --resistance-spread PERCENT, --soc-spread PERCENT\n"
+            "                           cell mismatch, standard deviation (default 3, 10, 3)\n"
+            "      --ambient C          ambient temperature (default 25)\n"
+            "      --dt S               time step (default 1)\n"
+            "      --max-time S         charge time limit (default 36000)\n"
+            "      --seed N             seed of the first pack (default 1)\n", name);
+        exit(2);
+    }
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    enum { SOC = 256, CAPACITY_SPREAD, RESISTANCE_SPREAD, SOC_SPREAD, AMBIENT, DT, MAX_TIME, SEED };
+    static const struct option longOptions[] = {
+        {"chemistry",       required_argument,  0, 'b'},
+        {"cells",           required_argument,  0, 'c'},
+        {"capacity",        required_argument,  0, 'C'},
+        {"current",         required_argument,  0, 'I'},
+        {"packs",           required_argument,  0, 'n'},
+        {"threads",         required_argument,  0, 'j'},
+        {"soc",             required_argument,  0, SOC},
+        {"capacity-spread", required_argument,  0, CAPACITY_SPREAD},
+        {"resistance-spread", required_argument, 0, RESISTANCE_SPREAD},
+        {"soc-spread",      required_argument,  0, SOC_SPREAD},
+        {"ambient",         required_argument,  0, AMBIENT},
+        {"dt",              required_argument,  0, DT},
+        {"max-time",        required_argument,  0, MAX_TIME},
+        {"seed",            required_argument,  0, SEED},
+        {"help",            no_argument,        0, 'h'},
+        {0, 0, 0, 0}
+    };
+
+    options.pack = BatteryModel::defaultPackConfig();
+    options.pack.capacitySpread = 0.03;
+    options.pack.resistanceSpread = 0.10;
+    options.pack.socSpread = 0.03;
+    options.pack.seed = 1;
+    options.packs = 1000;
+    options.threads = std::max(1u, std::thread::hardware_concurrency());
+    options.current = 1;
+    options.dt = 1;
+    options.maxTime = 36000;
+
+    int c;
+    while((c = getopt_long(argc, argv, "b:c:C:I:n:j:h", longOptions, 0)) != -1) {
+        switch(c) {
+        case 'b':
+            if(!findChemistry(optarg, options.pack.batteryType)) usage(argv[0]);
+            break;
+        case 'c':       options.pack.cells = atoi(optarg); break;
+        case 'C':       options.pack.capacity = atof(optarg) / 1000; break;
+        case 'I':       options.current = atof(optarg); break;
+        case 'n':       options.packs = atoi(optarg); break;
+        case 'j':       options.threads = std::max(1, atoi(optarg)); break;
+        case SOC:       options.pack.soc = atof(optarg) / 100; break;
+        case CAPACITY_SPREAD:   options.pack.capacitySpread = atof(optarg) / 100; break;
+        case RESISTANCE_SPREAD: options.pack.resistanceSpread = atof(optarg) / 100; break;
+        case SOC_SPREAD:        options.pack.socSpread = atof(optarg) / 100; break;
+        case AMBIENT:   options.pack.ambient = atof(optarg); break;
+        case DT:        options.dt = atof(optarg); break;
+        case MAX_TIME:  options.maxTime = atof(optarg); break;
+        case SEED:      options.pack.seed = atoi(optarg); break;
+        default:        usage(argv[0]);
+        }
+    }
+    if(optind < argc || options.packs == 0 || options.dt <= 0
+            || options.pack.cells == 0 || options.pack.cells > BATTERY_MODEL_MAX_CELLS
+            || options.pack.batteryType == 0)
+        usage(argv[0]);
+
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    std::vector<Result> results(options.packs);
+    std::atomic<unsigned> next(0);
+    std::vector<std::thread> threads;
+    for(unsigned i = 0; i < options.threads; i++)
+        threads.push_back(std::thread(worker, &next, &results));
+    for(size_t i = 0; i < threads.size(); i++)
+        threads[i].join();
+    double host = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    unsigned timeouts = 0;
+    for(size_t i = 0; i < results.size(); i++)
+        timeouts += results[i].timeout;
+
+    printf("%s %dS %.0fmAh, %.2fC, %u packs, %u threads, %.2f s\n",
+            BatteryModel::getChemistry(options.pack.batteryType).name,
+            options.pack.cells, options.pack.capacity * 1000, options.current,
+            options.packs, options.threads, host);
+    printf("%-16s %10s %10s %10s\n", "", "min", "mean", "max");
+    printStat("time (min)", stat(results, &Result::time), 1.0 / 60);
+    printStat("charge (mAh)", stat(results, &Result::charge), 1000);
+    printStat("energy (Wh)", stat(results, &Result::energy), 1);
+    printStat("overshoot (mV)", stat(results, &Result::overshoot), 1000);
+    printStat("spread (mV)", stat(results, &Result::spread), 1000);
+    printStat("max temp (C)", stat(results, &Result::maxTemperature), 1);
+    if(timeouts)
+        printf("timeouts: %u\n", timeouts);
+    return timeouts ? 1 : 0;
+}
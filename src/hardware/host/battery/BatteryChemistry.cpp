@@ -0,0 +1,59 @@
+/*
+    cheali-charger - open source firmware for a variety of LiPo chargers
+    Copyright (C) 2013  Paweł Stawicki. All right reserved.
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "BatteryModel.h"
+
+namespace BatteryModel {
+
+//typical cells, per cell values
+const Chemistry chemistries_[BATTERY_MODEL_CHEMISTRIES] = {
+//  name        ocv (SoC 0%..100%)
+//              dOcv/dT     Vc      Vd      r0      r1      tau1    r2      tau2    effSoc0 effSoc1 heatCap thermalR overcharge
+    {"None",    {3.00, 3.55, 3.68, 3.74, 3.77, 3.80, 3.84, 3.89, 3.95, 4.05, 4.20},
+                0,          4.20,   3.00,   0.040,  0.030,  20,     0.020,  400,    2.0,    2.0,    27,     30,     0},
+    {"NiCd",    {1.00, 1.15, 1.20, 1.22, 1.23, 1.24, 1.25, 1.27, 1.30, 1.36, 1.45},
+                -0.004,     1.80,   0.85,   0.040,  0.020,  30,     0.010,  300,    0.85,   1.05,   15,     60,     0},
+    {"NiMH",    {1.00, 1.18, 1.22, 1.24, 1.25, 1.26, 1.27, 1.29, 1.32, 1.38, 1.45},
+                -0.003,     1.80,   1.00,   0.050,  0.025,  30,     0.015,  300,    0.85,   1.05,   15,     60,     0},
+    {"Pb",      {1.90, 1.96, 1.99, 2.01, 2.03, 2.05, 2.07, 2.09, 2.11, 2.13, 2.15},
+                -0.0004,    2.45,   1.75,   0.025,  0.030,  60,     0.050,  1000,   0.90,   1.10,   40,     20,     3.0},
+    {"Life",    {2.50, 3.10, 3.20, 3.24, 3.26, 3.28, 3.29, 3.30, 3.31, 3.34, 3.60},
+                0,          3.60,   2.50,   0.030,  0.020,  20,     0.015,  400,    2.0,    2.0,    30,     30,     0},
+    {"Lilo",    {2.90, 3.45, 3.58, 3.66, 3.72, 3.77, 3.83, 3.89, 3.96, 4.03, 4.10},
+                0,          4.10,   2.50,   0.050,  0.030,  20,     0.020,  400,    2.0,    2.0,    27,     30,     0},
+    {"Lipo",    {3.00, 3.55, 3.68, 3.74, 3.77, 3.80, 3.84, 3.89, 3.95, 4.05, 4.20},
+                0,          4.20,   3.00,   0.040,  0.030,  20,     0.020,  400,    2.0,    2.0,    27,     30,     0},
+    {"Li430",   {3.00, 3.56, 3.69, 3.76, 3.80, 3.84, 3.89, 3.95, 4.03, 4.14, 4.30},
+                0,          4.30,   3.00,   0.040,  0.030,  20,     0.020,  400,    2.0,    2.0,    27,     30,     0},
+    {"Li435",   {3.00, 3.56, 3.70, 3.77, 3.81, 3.86, 3.91, 3.98, 4.06, 4.18, 4.35},
+                0,          4.35,   3.00,   0.040,  0.030,  20,     0.020,  400,    2.0,    2.0,    27,     30,     0},
+    {"NiZn",    {1.50, 1.65, 1.70, 1.72, 1.73, 1.74, 1.75, 1.76, 1.78, 1.82, 1.90},
+                -0.001,     1.90,   1.30,   0.030,  0.020,  30,     0.010,  300,    0.95,   1.10,   20,     50,     0},
+    {"Unknown", {3.00, 3.55, 3.68, 3.74, 3.77, 3.80, 3.84, 3.89, 3.95, 4.05, 4.20},
+                0,          4.20,   3.00,   0.040,  0.030,  20,     0.020,  400,    2.0,    2.0,    27,     30,     0},
+    {"LED",     {3.00, 3.55, 3.68, 3.74, 3.77, 3.80, 3.84, 3.89, 3.95, 4.05, 4.20},
+                0,          4.20,   3.00,   0.040,  0.030,  20,     0.020,  400,    2.0,    2.0,    27,     30,     0},
+};
+
+} // namespace BatteryModel
+
+const BatteryModel::Chemistry & BatteryModel::getChemistry(uint8_t batteryType)
+{
+    if(batteryType >= BATTERY_MODEL_CHEMISTRIES)
+        batteryType = 0;
+    return chemistries_[batteryType];
+}
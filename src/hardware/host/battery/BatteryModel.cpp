@@ -0,0 +1,176 @@
+/*
+    cheali-charger - open source firmware for a variety of LiPo chargers
+    Copyright (C) 2013  Paweł Stawicki. All right reserved.
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include <math.h>
+#include <random>
+#include "BatteryModel.h"
+
+#define BATTERY_MODEL_REFERENCE_T   25.0
+//resistance change per K below the reference temperature
+#define BATTERY_MODEL_R_PER_K       0.01
+
+namespace BatteryModel {
+
+    double clamp(double v, double min, double max) {
+        if(v < min) return min;
+        if(v > max) return max;
+        return v;
+    }
+
+} // namespace BatteryModel
+
+void BatteryModel::Cell::init(const Chemistry * chemistry, double capacity, double soc,
+        double resistanceFactor, double ambient)
+{
+    chemistry_ = chemistry;
+    capacity_ = capacity;
+    R0_ = chemistry->r0 / capacity * resistanceFactor;
+    R1_ = chemistry->r1 / capacity * resistanceFactor;
+    R2_ = chemistry->r2 / capacity * resistanceFactor;
+    heatCapacity_ = chemistry->heatCapacity * capacity;
+    thermalResistance_ = chemistry->thermalResistance / capacity;
+    temperatureFactor_ = 1;
+    soc_ = soc;
+    T_ = ambient;
+    v1_ = v2_ = 0;
+    I_ = 0;
+}
+
+double BatteryModel::Cell::getOcv() const
+{
+    const float * ocv = chemistry_->ocv;
+    double x = soc_ * (BATTERY_MODEL_OCV_POINTS - 1);
+    int i = (int) floor(x);
+    //outside 0%..100%: extrapolate the first/last segment
+    if(i < 0) i = 0;
+    if(i > BATTERY_MODEL_OCV_POINTS - 2) i = BATTERY_MODEL_OCV_POINTS - 2;
+    double v = ocv[i] + (x - i) * (ocv[i + 1] - ocv[i]);
+    if(soc_ > 1)
+        v += chemistry_->overcharge * (soc_ - 1);
+    return v + chemistry_->dOcv_dT * (T_ - BATTERY_MODEL_REFERENCE_T);
+}
+
+void BatteryModel::Cell::step(double I, double dt, double ambient)
+{
+    step(I, dt, ambient, exp(-dt / chemistry_->tau1), exp(-dt / chemistry_->tau2));
+}
+
+void BatteryModel::Cell::step(double I, double dt, double ambient, double k1, double k2)
+{
+    I_ = I;
+    double ocv = getOcv();
+
+    //charge efficiency: above effSoc0 part of the charge turns into heat
+    double efficiency = 1;
+    if(I > 0 && soc_ > chemistry_->effSoc0) {
+        efficiency = (chemistry_->effSoc1 - soc_) / (chemistry_->effSoc1 - chemistry_->effSoc0);
+        efficiency = clamp(efficiency, 0, 1);
+    }
+    soc_ += I * efficiency * dt / 3600 / capacity_;
+
+    double R1 = R1_ * temperatureFactor_;
+    double R2 = R2_ * temperatureFactor_;
+    v1_ = I * R1 + (v1_ - I * R1) * k1;
+    v2_ = I * R2 + (v2_ - I * R2) * k2;
+
+    double heat = I * I * getR0() + v1_ * v1_ / R1 + v2_ * v2_ / R2
+            + (1 - efficiency) * I * ocv;
+    T_ += (heat - (T_ - ambient) / thermalResistance_) * dt / heatCapacity_;
+    temperatureFactor_ = clamp(1 + BATTERY_MODEL_R_PER_K * (BATTERY_MODEL_REFERENCE_T - T_), 0.5, 3);
+}
+
+
+BatteryModel::PackConfig BatteryModel::defaultPackConfig()
+{
+    PackConfig c;
+    c.batteryType = 6;      //ProgramData::Lipo
+    c.cells = 3;
+    c.capacity = 2.2;
+    c.soc = 0.1;
+    c.ambient = 25;
+    c.capacitySpread = 0;
+    c.resistanceSpread = 0;
+    c.socSpread = 0;
+    c.seed = 1;
+    return c;
+}
+
+void BatteryModel::Pack::init(const PackConfig &config)
+{
+    chemistry_ = &BatteryModel::getChemistry(config.batteryType);
+    cells_ = config.cells;
+    if(cells_ > BATTERY_MODEL_MAX_CELLS)
+        cells_ = BATTERY_MODEL_MAX_CELLS;
+    ambient_ = config.ambient;
+    dt_ = 0;
+
+    std::mt19937 random(config.seed);
+    std::normal_distribution<double> normal;
+    for(uint8_t i = 0; i < cells_; i++) {
+        double capacity = config.capacity * clamp(1 + config.capacitySpread * normal(random), 0.2, 2);
+        double resistance = clamp(1 + config.resistanceSpread * normal(random), 0.2, 5);
+        double soc = clamp(config.soc + config.socSpread * normal(random), 0, 1);
+        cell_[i].init(chemistry_, capacity, soc, resistance, ambient_);
+    }
+}
+
+void BatteryModel::Pack::step(double I, double dt, uint16_t balancer, double Rbalancer)
+{
+    if(dt != dt_) {
+        dt_ = dt;
+        k1_ = exp(-dt / chemistry_->tau1);
+        k2_ = exp(-dt / chemistry_->tau2);
+    }
+    for(uint8_t i = 0; i < cells_; i++) {
+        double Icell = I;
+        if((balancer & (1 << i)) && Rbalancer > 0)
+            Icell -= cell_[i].getVoltage() / Rbalancer;
+        cell_[i].step(Icell, dt, ambient_, k1_, k2_);
+    }
+}
+
+double BatteryModel::Pack::getVoltage() const
+{
+    double v = 0;
+    for(uint8_t i = 0; i < cells_; i++)
+        v += cell_[i].getVoltage();
+    return v;
+}
+
+double BatteryModel::Pack::getInternalVoltage() const
+{
+    double v = 0;
+    for(uint8_t i = 0; i < cells_; i++)
+        v += cell_[i].getInternalVoltage();
+    return v;
+}
+
+double BatteryModel::Pack::getResistance() const
+{
+    double r = 0;
+    for(uint8_t i = 0; i < cells_; i++)
+        r += cell_[i].getR0();
+    return r;
+}
+
+double BatteryModel::Pack::getTemperature() const
+{
+    double t = 0;
+    for(uint8_t i = 0; i < cells_; i++)
+        t += cell_[i].getTemperature();
+    return cells_ ? t / cells_ : ambient_;
+}
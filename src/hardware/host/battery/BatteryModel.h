@@ -0,0 +1,130 @@
+/*
+    cheali-charger - open source firmware for a variety of LiPo chargers
+    Copyright (C) 2013  Paweł Stawicki. All right reserved.
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#ifndef BATTERY_MODEL_H_
+#define BATTERY_MODEL_H_
+
+#include <stdint.h>
+
+/*
+ * equivalent circuit battery model (host only)
+ *
+ * cell: OCV(SoC, T) - R0 - R1||C1 - R2||C2, charge efficiency (NiXX, Pb
+ * gassing), lumped thermal mass with a thermal resistance to ambient.
+ * pack: cells in series with a random mismatch of capacity, resistance
+ * and initial SoC; a balancer bleed resistor per cell.
+ *
+ * All values in SI units (V, A, ohm, s, C, J), the current is positive
+ * when charging. Pack and Cell have no global state: one pack per thread.
+ */
+namespace BatteryModel {
+
+    #define BATTERY_MODEL_OCV_POINTS    11
+    #define BATTERY_MODEL_MAX_CELLS     16
+    //ProgramData::LAST_BATTERY_TYPE
+    #define BATTERY_MODEL_CHEMISTRIES   12
+
+    struct Chemistry {
+        const char * name;
+        //open circuit voltage at 25C, SoC 0%..100% in 10% steps
+        float ocv[BATTERY_MODEL_OCV_POINTS];
+        float dOcv_dT;          //V/K
+        float Vcharged;         //V, ProgramData VCharged
+        float Vdischarged;      //V, ProgramData VDischarged
+        //resistances of a 1Ah cell (ohm*Ah), time constants (s)
+        float r0, r1, tau1, r2, tau2;
+        //charge efficiency: 1 below effSoc0, falls to 0 at effSoc1
+        float effSoc0, effSoc1;
+        //heat capacity (J/K) and thermal resistance to ambient (K*Ah/W) of a 1Ah cell
+        float heatCapacity, thermalResistance;
+        //gassing overpotential above 100% SoC (V per 100% SoC), Pb
+        float overcharge;
+    };
+
+    //index: ProgramData::BatteryType
+    const Chemistry & getChemistry(uint8_t batteryType);
+
+    class Cell {
+    public:
+        void init(const Chemistry * chemistry, double capacity, double soc,
+                double resistanceFactor, double ambient);
+        //current I (A) for dt seconds
+        void step(double I, double dt, double ambient);
+        //the same with the R1||C1, R2||C2 decays exp(-dt/tau) given (see: Pack)
+        void step(double I, double dt, double ambient, double k1, double k2);
+
+        double getOcv() const;
+        //voltage without the R0 drop
+        double getInternalVoltage() const { return getOcv() + v1_ + v2_; }
+        double getVoltage() const { return getInternalVoltage() + I_ * getR0(); }
+        double getR0() const { return R0_ * temperatureFactor_; }
+        double getSoc() const { return soc_; }
+        double getTemperature() const { return T_; }
+        double getCapacity() const { return capacity_; }
+    private:
+        const Chemistry * chemistry_;
+        double capacity_;           //Ah
+        double R0_, R1_, R2_;
+        double temperatureFactor_;
+        double heatCapacity_, thermalResistance_;
+        double soc_, T_;
+        double v1_, v2_;
+        double I_;
+    };
+
+    struct PackConfig {
+        uint8_t batteryType;        //ProgramData::BatteryType
+        uint8_t cells;
+        double capacity;            //Ah, nominal
+        double soc;                 //0..1, nominal initial SoC
+        double ambient;             //C
+        //mismatch between cells: relative standard deviations, SoC: absolute
+        double capacitySpread;
+        double resistanceSpread;
+        double socSpread;
+        uint32_t seed;
+    };
+    PackConfig defaultPackConfig();
+
+    class Pack {
+    public:
+        void init(const PackConfig &config);
+        //pack current I (A), balancer: bit i - bleed resistor on cell i
+        void step(double I, double dt, uint16_t balancer = 0, double Rbalancer = 0);
+
+        uint8_t getCells() const { return cells_; }
+        const Cell & getCell(uint8_t i) const { return cell_[i]; }
+        const Chemistry & getChemistry() const { return *chemistry_; }
+        double getVoltage() const;
+        double getInternalVoltage() const;
+        double getResistance() const;
+        //mean cell temperature (external temperature sensor)
+        double getTemperature() const;
+        double getAmbient() const { return ambient_; }
+        void setAmbient(double ambient) { ambient_ = ambient; }
+    private:
+        const Chemistry * chemistry_;
+        uint8_t cells_;
+        double ambient_;
+        Cell cell_[BATTERY_MODEL_MAX_CELLS];
+        //cached decays, the simulation steps with a constant dt
+        double dt_, k1_, k2_;
+    };
+
+} // namespace BatteryModel
+
+#endif /* BATTERY_MODEL_H_ */
@@ -0,0 +1,8 @@
+
+set(BATTERY_SOURCE
+    BatteryModel.h
+    BatteryModel.cpp
+    BatteryChemistry.cpp
+)
+
+CHEALI_ADD(GENERIC_SOURCE_FILES "${BATTERY_SOURCE}")
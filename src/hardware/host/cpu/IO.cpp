@@ -0,0 +1,41 @@
+/*
+    cheali-charger - open source firmware for a variety of LiPo chargers
+    Copyright (C) 2013  Paweł Stawicki. All right reserved.
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "IO.h"
+#include "Simulation.h"
+
+namespace IO {
+    uint8_t pins_[256];
+}
+
+void IO::pinMode(uint8_t pinNumber, uint8_t mode)
+{
+}
+
+void IO::digitalWrite(uint8_t pinNumber, uint32_t value)
+{
+    uint8_t v = value ? HIGH : LOW;
+    if(pins_[pinNumber] != v) {
+        pins_[pinNumber] = v;
+        Simulation::pinChanged(pinNumber, v);
+    }
+}
+
+uint8_t IO::digitalRead(uint8_t pinNumber)
+{
+    return pins_[pinNumber];
+}
@@ -0,0 +1,37 @@
+/*
+    cheali-charger - open source firmware for a variety of LiPo chargers
+    Copyright (C) 2013  Paweł Stawicki. All right reserved.
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#ifndef IO_H_
+#define IO_H_
+
+#include <stdint.h>
+
+#define OUTPUT 1
+#define INPUT 0
+#define ANALOG_INPUT 2
+#define HIGH 1
+#define LOW 0
+
+//pins of the simulated board, every change is passed to Simulation::pinChanged
+namespace IO
+{
+    void pinMode(uint8_t pinNumber, uint8_t mode);
+    void digitalWrite(uint8_t pinNumber, uint32_t value);
+    uint8_t digitalRead(uint8_t pinNumber);
+}
+
+#endif /* IO_H_ */
@@ -0,0 +1,36 @@
+/*
+    cheali-charger - open source firmware for a variety of LiPo chargers
+    Copyright (C) 2013  Paweł Stawicki. All right reserved.
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#ifndef PROFILERCLOCK_H_
+#define PROFILERCLOCK_H_
+
+#include <stdint.h>
+#include "Simulation.h"
+
+//virtual time of the simulation in microseconds, wraps at 2^32 (71 minutes)
+#define PROFILER_CLOCK_WRAP 0
+#define PROFILER_CLOCK_TICKS_PER_US 1
+
+namespace ProfilerClock {
+    inline void initialize() {}
+
+    inline uint32_t get() {
+        return uint32_t(Simulation::getMicroseconds());
+    }
+}
+
+#endif /* PROFILERCLOCK_H_ */
@@ -0,0 +1,86 @@
+/*
+    cheali-charger - open source firmware for a variety of LiPo chargers
+    Copyright (C) 2013  Paweł Stawicki. All right reserved.
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "Serial.h"
+
+#define Rx_BUFFER_SIZE  256
+
+namespace Serial {
+    FILE * output_;
+    bool open_;
+    void (*listener_)(uint8_t c);
+
+    uint8_t rxBuffer_[Rx_BUFFER_SIZE];
+    uint16_t rxHead_, rxTail_;
+}
+
+void Serial::begin(unsigned long baud)
+{
+    open_ = true;
+}
+
+void Serial::write(uint8_t c)
+{
+    if(!open_)
+        return;
+    fputc(c, output_ ? output_ : stdout);
+    if(listener_)
+        listener_(c);
+}
+
+void Serial::flush()
+{
+}
+
+void Serial::end()
+{
+    open_ = false;
+}
+
+void Serial::initialize()
+{
+}
+
+int Serial::read()
+{
+    if(rxHead_ == rxTail_)
+        return -1;
+    uint8_t c = rxBuffer_[rxTail_];
+    rxTail_ = (rxTail_ + 1) % Rx_BUFFER_SIZE;
+    return c;
+}
+
+void Serial::setOutput(FILE * f)
+{
+    output_ = f;
+}
+
+void Serial::setListener(void (*listener)(uint8_t c))
+{
+    listener_ = listener;
+}
+
+void Serial::receive(const char * s)
+{
+    while(*s) {
+        uint16_t next = (rxHead_ + 1) % Rx_BUFFER_SIZE;
+        if(next == rxTail_)
+            return;
+        rxBuffer_[rxHead_] = *s++;
+        rxHead_ = next;
+    }
+}
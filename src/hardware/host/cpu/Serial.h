@@ -0,0 +1,40 @@
+/*
+    cheali-charger - open source firmware for a variety of LiPo chargers
+    Copyright (C) 2013  Paweł Stawicki. All right reserved.
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#ifndef Serial_H_
+#define Serial_H_
+
+#include <stdio.h>
+#include <stdint.h>
+
+namespace Serial {
+    void  begin(unsigned long baud);
+    void  write(uint8_t c);
+    void  flush();
+    void  end();
+    void  initialize();
+    int   read();
+
+    //host only: where the transmitted bytes go (default: stdout)
+    void setOutput(FILE * f);
+    //host only: called with every transmitted byte
+    void setListener(void (*listener)(uint8_t c));
+    //host only: bytes for read(), as if received on the RX line
+    void receive(const char * s);
+} // namespace Serial
+
+#endif //  Serial_H_
@@ -0,0 +1,129 @@
+/*
+    cheali-charger - open source firmware for a variety of LiPo chargers
+    Copyright (C) 2013  Paweł Stawicki. All right reserved.
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "Simulation.h"
+
+#define SIMULATION_MAX_INTERRUPTS 8
+
+namespace Simulation {
+    uint32_t cpuTimeUs = 20;
+    uint64_t idleUs;
+
+    struct Source {
+        Interrupt isr;
+        uint32_t period;
+        uint64_t deadline;
+    };
+
+    Source sources_[SIMULATION_MAX_INTERRUPTS];
+    uint8_t sourcesCount_;
+
+    uint64_t now_;
+    uint8_t disabled_;
+    bool inInterrupt_;
+
+    Source * findSource(Interrupt isr) {
+        for(uint8_t i = 0; i < sourcesCount_; i++) {
+            if(sources_[i].isr == isr)
+                return &sources_[i];
+        }
+        return 0;
+    }
+
+    //run all interrupts with a deadline before "end", then set the time to "end"
+    void advance(uint64_t end) {
+        inInterrupt_ = true;
+        while(true) {
+            Source * next = 0;
+            for(uint8_t i = 0; i < sourcesCount_; i++) {
+                if(sources_[i].deadline <= end && (!next || sources_[i].deadline < next->deadline))
+                    next = &sources_[i];
+            }
+            if(!next)
+                break;
+            if(now_ < next->deadline)
+                now_ = next->deadline;
+            next->deadline += next->period;
+            next->isr();
+        }
+        now_ = end;
+        inInterrupt_ = false;
+    }
+
+} // namespace Simulation
+
+uint64_t Simulation::getMicroseconds()
+{
+    return now_;
+}
+
+void Simulation::addInterrupt(Interrupt isr, uint32_t periodUs)
+{
+    if(sourcesCount_ >= SIMULATION_MAX_INTERRUPTS)
+        return;
+    Source &s = sources_[sourcesCount_++];
+    s.isr = isr;
+    s.period = periodUs;
+    s.deadline = now_ + periodUs;
+}
+
+void Simulation::setInterruptPeriod(Interrupt isr, uint32_t periodUs)
+{
+    Source * s = findSource(isr);
+    if(s) {
+        //like a restarted hardware timer
+        s->deadline = now_ + periodUs;
+        s->period = periodUs;
+    }
+}
+
+bool Simulation::inInterrupt()
+{
+    return inInterrupt_;
+}
+
+uint8_t Simulation::disableInterrupts()
+{
+    disabled_++;
+    return 1;
+}
+
+void Simulation::restoreInterrupts()
+{
+    if(--disabled_ == 0 && !inInterrupt_)
+        advance(now_ + cpuTimeUs);
+}
+
+void Simulation::spend(uint32_t us)
+{
+    if(disabled_ == 0 && !inInterrupt_)
+        advance(now_ + us);
+}
+
+void Simulation::idle()
+{
+    if(disabled_ || inInterrupt_ || sourcesCount_ == 0)
+        return;
+    uint64_t next = sources_[0].deadline;
+    for(uint8_t i = 1; i < sourcesCount_; i++) {
+        if(sources_[i].deadline < next)
+            next = sources_[i].deadline;
+    }
+    if(next > now_)
+        idleUs += next - now_;
+    advance(next);
+}
@@ -0,0 +1,64 @@
+/*
+    cheali-charger - open source firmware for a variety of LiPo chargers
+    Copyright (C) 2013  Paweł Stawicki. All right reserved.
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#ifndef SIMULATION_H_
+#define SIMULATION_H_
+
+#include <stdint.h>
+
+/*
+ * virtual clock of the host build
+ *
+ * There are no real interrupts on the host. The firmware runs in one thread
+ * and its "interrupts" are called from interrupt points:
+ *  - the end of every outermost ATOMIC_BLOCK (interrupts enabled again),
+ *  - Utils::delayMicroseconds().
+ * Every interrupt point advances the virtual time by cpuTimeUs (the time the
+ * main program needs between two interrupt points), delayMicroseconds by the
+ * requested time. All interrupts whose deadline was reached are called in
+ * deadline order. Busy waits of the firmware (Time::delay, Keyboard, ...)
+ * read the time with ATOMIC_BLOCK, so they run the clock forward.
+ */
+namespace Simulation {
+    typedef void (*Interrupt)();
+
+    //virtual time of the main program between two interrupt points
+    extern uint32_t cpuTimeUs;
+
+    uint64_t getMicroseconds();
+
+    //periodic interrupt, the first call is after periodUs
+    void addInterrupt(Interrupt isr, uint32_t periodUs);
+    void setInterruptPeriod(Interrupt isr, uint32_t periodUs);
+    bool inInterrupt();
+
+    //ATOMIC_BLOCK
+    uint8_t disableInterrupts();
+    void restoreInterrupts();
+
+    //busy wait of the main program
+    void spend(uint32_t us);
+    //sleep of the main program: the time jumps to the next interrupt
+    void idle();
+    //virtual time spent in idle()
+    extern uint64_t idleUs;
+
+    //implemented by the simulated board (generic), called from IO::digitalWrite
+    void pinChanged(uint8_t pin, uint8_t value);
+}
+
+#endif /* SIMULATION_H_ */
@@ -0,0 +1,14 @@
+
+set(CPU_SOURCE
+    atomic.h  cpu.h  cpu.cpp  IO.h  IO.cpp  memory.h  memory.cpp
+    Serial.h  Serial.cpp  Timer0.cpp  Utils.cpp  Simulation.h  Simulation.cpp
+)
+
+CHEALI_ADD(CPU_SOURCE_FILES "${CPU_SOURCE}")
+
+include_directories(${CMAKE_CURRENT_LIST_DIR}/..)
+
+#the simulator has its own main(argc, argv), the firmware main() is started from it
+set_source_files_properties(${CMAKE_SOURCE_DIR}/src/core/ChealiCharger2.cpp PROPERTIES COMPILE_DEFINITIONS main=chealiMain)
+
+link_libraries(m)
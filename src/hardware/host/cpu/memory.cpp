@@ -0,0 +1,41 @@
+/*
+    cheali-charger - open source firmware for a variety of LiPo chargers
+    Copyright (C) 2013  Paweł Stawicki. All right reserved.
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "memory.h"
+
+namespace eeprom {
+
+    uint32_t writtenBytes;
+
+    void write_impl(uint8_t * addressE, const uint8_t * data, int size)
+    {
+        //like eeprom_update_block: only changed bytes are written
+        for(int i = 0; i < size; i++) {
+            if(addressE[i] != data[i]) {
+                addressE[i] = data[i];
+                writtenBytes++;
+            }
+        }
+    }
+
+    bool tryUpdateByte(uint8_t * addressE, uint8_t value)
+    {
+        write_impl(addressE, &value, 1);
+        return true;
+    }
+
+} // namespace eeprom
@@ -0,0 +1,190 @@
+/*
+    cheali-charger - open source firmware for a variety of LiPo chargers
+    Copyright (C) 2013  Paweł Stawicki. All right reserved.
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include <stdlib.h>
+#include <math.h>
+#include "Hardware.h"
+#include "SMPS_PID.h"
+#include "AnalogInputsPrivate.h"
+#include "SMPS.h"
+#include "Discharger.h"
+#include "Utils.h"
+#include "Simulation.h"
+#include "Plant.h"
+#include "IsrProfiler.h"
+
+#define ADC_I_SMPS_PER_ROUND 4
+#define ADC_MAX_12BIT ((1 << ANALOG_INPUTS_ADC_RESOLUTION_BITS) - 1)
+
+namespace AnalogInputsADC {
+
+double noise = 0.5;
+
+static uint8_t current_input_;
+static bool g_addSumToInput;
+
+struct adc_correlation {
+    AnalogInputs::Name ai_name_;
+    bool trigger_PID_;
+};
+
+//the nuvoton 50W order
+const adc_correlation order_analogInputs_on[] = {
+    {AnalogInputs::Vb0_pin,         false},
+    {AnalogInputs::Vout_minus_pin,  false},
+    {AnalogInputs::Vb1_pin,         false},
+    {AnalogInputs::Ismps,           true},
+    {AnalogInputs::Vb2_pin,         false},
+    {AnalogInputs::Vout_plus_pin,   false},
+    {AnalogInputs::Vb6_pin,         false},
+    {AnalogInputs::Ismps,           true},
+    {AnalogInputs::Vb5_pin,         false},
+    {AnalogInputs::Idischarge,      false},
+    {AnalogInputs::Vb4_pin,         false},
+    {AnalogInputs::Ismps,           true},
+    {AnalogInputs::Vb3_pin,         false},
+    {AnalogInputs::Vin,             false},
+    {AnalogInputs::Textern,         false},
+    {AnalogInputs::Tintern,         false},
+    {AnalogInputs::Ismps,           true},
+};
+
+inline uint8_t nextInput(uint8_t i) {
+    i++;
+    if(i >= sizeOfArray(order_analogInputs_on)) i=0;
+    return i;
+}
+
+//standard normal distribution (Box-Muller)
+double gauss() {
+    double u1 = (rand() + 1.0) / (RAND_MAX + 2.0);
+    double u2 = (rand() + 1.0) / (RAND_MAX + 2.0);
+    return sqrt(-2 * log(u1)) * cos(2 * M_PI * u2);
+}
+
+double clamp(double v, double max) {
+    if(v < 0) return 0;
+    if(v > max) return max;
+    return v;
+}
+
+double getMean(AnalogInputs::Name name)
+{
+    return clamp(toADC(name, Plant::getInput(name)) / 16, ADC_MAX_12BIT);
+}
+
+//one 12bit conversion, pretend 16bit adc
+uint16_t convertOne(double mean)
+{
+    double v = mean;
+    if(noise > 0)
+        v += noise * gauss();
+    return uint16_t(clamp(floor(v + 0.5), ADC_MAX_12BIT)) << 4;
+}
+
+//one burst: ANALOG_INPUTS_ADC_BURST_COUNT 12bit conversions of the same input
+void convert(AnalogInputs::Name name)
+{
+    const uint32_t n = ANALOG_INPUTS_ADC_BURST_COUNT;
+    double mean = getMean(name);
+    double sum;
+    uint16_t last;
+    if(noise > 0) {
+        //the noise dithers the quantization, the sum keeps the fraction
+        sum = floor(n * mean + noise * sqrt(double(n)) * gauss() + 0.5);
+        last = convertOne(mean);
+    } else {
+        last = convertOne(mean);
+        sum = n * (last >> 4);
+    }
+    sum = clamp(sum, n * ADC_MAX_12BIT);
+
+    AnalogInputs::i_adc_[name] = last;
+    if(g_addSumToInput)
+        AnalogInputs::i_avrSum_[name] += uint32_t(sum) << 4;
+}
+
+void finalizeMeasurement()
+{
+    AnalogInputs::i_adc_[AnalogInputs::IsmpsSet]        = SMPS::getValue();
+    AnalogInputs::i_adc_[AnalogInputs::IdischargeSet]   = Discharger::getValue();
+    AnalogInputs::intterruptIntegrate();
+
+    if(g_addSumToInput) {
+        AnalogInputs::i_avrSum_[AnalogInputs::IsmpsSet]        += SMPS::getValue() * ANALOG_INPUTS_ADC_BURST_COUNT;
+        AnalogInputs::i_avrSum_[AnalogInputs::IdischargeSet]   += Discharger::getValue() * ANALOG_INPUTS_ADC_BURST_COUNT;
+        if(AnalogInputs::i_avrCount_ == 1) {
+            AnalogInputs::i_avrSum_[AnalogInputs::Ismps]          /= ADC_I_SMPS_PER_ROUND;
+        }
+        AnalogInputs::intterruptFinalizeMeasurement();
+    }
+}
+
+//"ADC interrupt": the burst of current_input_ is done
+void conversionDone()
+{
+    IsrProfiler::Scope profile(IsrProfiler::AdcIsr);
+    Plant::step(Simulation::getMicroseconds());
+    convert(order_analogInputs_on[current_input_].ai_name_);
+
+    current_input_ = nextInput(current_input_);
+
+    if(current_input_ == 0) {
+        finalizeMeasurement();
+        g_addSumToInput = AnalogInputs::i_avrCount_ > 0;
+    }
+
+    if(!SMPS_PID_PERIOD_US && order_analogInputs_on[current_input_].trigger_PID_)
+        SMPS_PID::update();
+}
+
+//SMPS_PID_PERIOD_US: the current loop has its own timer and an injected Ismps conversion
+void pidInterrupt()
+{
+    IsrProfiler::Scope profile(IsrProfiler::PidIsr);
+    Plant::step(Simulation::getMicroseconds());
+    AnalogInputs::i_adc_[AnalogInputs::Ismps] = convertOne(getMean(AnalogInputs::Ismps));
+    SMPS_PID::update();
+}
+
+void initialize()
+{
+    current_input_ = 0;
+    g_addSumToInput = false;
+    Plant::initialize();
+    Simulation::addInterrupt(conversionDone, SIMULATION_ADC_BURST_US);
+    if(SMPS_PID_PERIOD_US)
+        Simulation::addInterrupt(pidInterrupt, SMPS_PID_PERIOD_US);
+}
+
+double toADC(AnalogInputs::Name name, double value)
+{
+    const AnalogInputs::DefaultValues &d = AnalogInputs::inputsP_[name];
+    double dx = double(d.p1.x) - d.p0.x;
+    double dy = double(d.p1.y) - d.p0.y;
+    return d.p0.x + (value - d.p0.y) * dx / dy;
+}
+
+double toValue(AnalogInputs::Name name, double adc)
+{
+    const AnalogInputs::DefaultValues &d = AnalogInputs::inputsP_[name];
+    double dx = double(d.p1.x) - d.p0.x;
+    double dy = double(d.p1.y) - d.p0.y;
+    return d.p0.y + (adc - d.p0.x) * dy / dx;
+}
+
+} // namespace AnalogInputsADC
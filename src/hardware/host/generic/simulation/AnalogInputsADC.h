@@ -0,0 +1,40 @@
+/*
+    cheali-charger - open source firmware for a variety of LiPo chargers
+    Copyright (C) 2013  Paweł Stawicki. All right reserved.
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#ifndef ANALOG_INPUTS_ADC_H_
+#define ANALOG_INPUTS_ADC_H_
+
+#include "AnalogInputs.h"
+
+/*
+ * ADC of the simulated board: one "interrupt" per burst (like the M0517 ADC
+ * in burst mode), the inputs are read from the Plant.
+ * The sensors are ideal: the default calibration (inputsP_) is the truth.
+ */
+namespace AnalogInputsADC
+{
+    //rms noise of a single conversion in 12bit LSB
+    extern double noise;
+
+    void initialize();
+
+    //sensor model: value in firmware units (mV, mA, 0.01C) <-> 16bit ADC value
+    double toADC(AnalogInputs::Name name, double value);
+    double toValue(AnalogInputs::Name name, double adc);
+};
+
+#endif /* ANALOG_INPUTS_ADC_H_ */
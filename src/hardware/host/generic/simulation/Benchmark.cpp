@@ -0,0 +1,138 @@
+/*
+    cheali-charger - open source firmware for a variety of LiPo chargers
+    Copyright (C) 2013  Paweł Stawicki. All right reserved.
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <vector>
+#include <algorithm>
+#if defined(__i386__) || defined(__x86_64__)
+#include <x86intrin.h>
+#endif
+#include "Benchmark.h"
+#include "Simulation.h"
+#include "Plant.h"
+#include "Hardware.h"
+#include "AnalogInputsPrivate.h"
+#include "ProgramData.h"
+#include "Program.h"
+#include "Strategy.h"
+#include "Monitor.h"
+#include "Settings.h"
+#include "memory.h"
+#include "Utils.h"
+#include "ChealiCharger2.h"
+
+#define BENCHMARK_WARM_UP_PASSES    100
+
+//not in the headers
+namespace Program {
+    void setupProgramType(ProgramType prog);
+}
+namespace AnalogInputs {
+    void finalizeFullMeasurement();
+}
+namespace SerialLog {
+    void sendChannel1();
+}
+
+namespace Benchmark {
+
+    uint64_t cycles() {
+#if defined(__i386__) || defined(__x86_64__)
+        return __rdtsc();
+#else
+        timespec t;
+        clock_gettime(CLOCK_MONOTONIC, &t);
+        return t.tv_sec * 1000000000ULL + t.tv_nsec;
+#endif
+    }
+
+    void printTimes(const char * name, std::vector<uint64_t> &times) {
+#if defined(__i386__) || defined(__x86_64__)
+        const char * unit = "cycles";
+#else
+        const char * unit = "ns";
+#endif
+        std::sort(times.begin(), times.end());
+        uint64_t sum = 0;
+        for(size_t i = 0; i < times.size(); i++)
+            sum += times[i];
+        fprintf(stderr, "%s, %s per pass: min %llu, median %llu, mean %llu, max %llu\n", name, unit,
+                (unsigned long long)times.front(), (unsigned long long)times[times.size() / 2],
+                (unsigned long long)(sum / times.size()), (unsigned long long)times.back());
+    }
+
+    void waitFullMeasurement() {
+        while(AnalogInputs::i_avrCount_ != 0)
+            Utils::delayMicroseconds(100);
+    }
+
+} // namespace Benchmark
+
+void Benchmark::run(int program, int batteryType, unsigned passes)
+{
+    setup();
+    //eeprom::restoreDefault() without the screens
+    AnalogInputs::restoreDefault();
+    ProgramData::restoreDefault();
+    Settings::restoreDefault();
+    ProgramData::loadProgramData(0);
+    ProgramData::battery.type = batteryType;
+    ProgramData::changedType();
+    ProgramData::battery.cells = Plant::config.pack.cells;
+    ProgramData::battery.capacity = uint16_t(Plant::config.pack.capacity * 1000 + 0.5);
+    ProgramData::battery.Ic = ProgramData::battery.capacity;
+    ProgramData::check();
+
+    Program::programType = Program::ProgramType(program);
+    Program::setupProgramType(Program::programType);
+    AnalogInputs::powerOn();
+    Monitor::powerOn();
+    callVoidMethod_P(&Strategy::strategy->powerOn);
+    Strategy::statusType (*doStrategy)() = pgm::read(&Strategy::strategy->doStrategy);
+
+    std::vector<uint64_t> times, logTimes;
+    uint64_t startUs = Simulation::getMicroseconds();
+    Strategy::statusType status = Strategy::RUNNING;
+    for(unsigned i = 0; i < BENCHMARK_WARM_UP_PASSES + passes && status == Strategy::RUNNING; i++) {
+        waitFullMeasurement();
+        uint64_t start = cycles();
+        AnalogInputs::finalizeFullMeasurement();
+        status = doStrategy();
+        uint64_t end = cycles();
+        //the serial log frame of the pass (Serial::write goes to the --log file)
+        SerialLog::sendChannel1();
+        uint64_t logEnd = cycles();
+        if(i >= BENCHMARK_WARM_UP_PASSES) {
+            times.push_back(end - start);
+            logTimes.push_back(logEnd - end);
+        }
+    }
+    callVoidMethod_P(&Strategy::strategy->powerOff);
+
+    if(times.empty()) {
+        fprintf(stderr, "benchmark: the program ended during the warm up\n");
+        exit(1);
+    }
+    fprintf(stderr, "benchmark: %u passes of finalizeFullMeasurement + doStrategy, %.1f s virtual%s\n",
+            unsigned(times.size()), (Simulation::getMicroseconds() - startUs) * 1e-6,
+            status == Strategy::RUNNING ? "" : " (program ended)");
+    printTimes("measurement + strategy", times);
+    printTimes("SerialLog::sendChannel1", logTimes);
+    exit(0);
+}
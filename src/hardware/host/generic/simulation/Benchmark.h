@@ -0,0 +1,31 @@
+/*
+    cheali-charger - open source firmware for a variety of LiPo chargers
+    Copyright (C) 2013  Paweł Stawicki. All right reserved.
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#ifndef BENCHMARK_H_
+#define BENCHMARK_H_
+
+/*
+ * host cycle count of the measurement/strategy pass: after a warm up
+ * AnalogInputs::finalizeFullMeasurement() + the doStrategy() of the program
+ * is timed once per full measurement; the program data is set up
+ * like the simulation (battery type, cells, capacity, Ic = 1C)
+ */
+namespace Benchmark {
+    void run(int program, int batteryType, unsigned passes);
+}
+
+#endif /* BENCHMARK_H_ */
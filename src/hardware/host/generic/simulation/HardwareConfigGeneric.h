@@ -0,0 +1,51 @@
+/*
+    cheali-charger - open source firmware for a variety of LiPo chargers
+    Copyright (C) 2013  Paweł Stawicki. All right reserved.
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#ifndef HARDWARE_CONFIG_GENERIC_H_
+#define HARDWARE_CONFIG_GENERIC_H_
+
+
+#include "AnalogInputsTypes.h"
+
+//the simulated board follows the nuvoton 50W (imaxB6) charger
+
+#define MAX_BALANCE_CELLS       6
+
+#define CALIBRATION_CHARGE_POINT0_mA    100
+#define CALIBRATION_CHARGE_POINT1_mA    1000
+#define CALIBRATION_DISCHARGE_POINT0_mA 100
+#define CALIBRATION_DISCHARGE_POINT1_mA 300
+
+#define ENABLE_GET_PID_VALUE
+#define ENABLE_EXPERT_VOLTAGE_CALIBRATION
+#define ENABLE_T_INTERNAL
+#define ENABLE_ISR_PROFILER
+
+#define ANALOG_INPUTS_ADC_BURST_COUNT           70
+#define ANALOG_INPUTS_ADC_ROUND_MAX_COUNT       100
+#define ANALOG_INPUTS_ADC_DELTA_SHIFT           4
+#define ANALOG_INPUTS_ADC_RESOLUTION_BITS       12
+
+#define ANALOG_INPUTS_MAX_ADC_Vout_plus_pin     ANALOG_INPUTS_MAX_ADC_VALUE
+
+//virtual time of one ADC burst (70 conversions of the M0517 ADC)
+#define SIMULATION_ADC_BURST_US                 400
+
+#define CHEALI_CHARGER_ARCHITECTURE_GENERIC             1
+#define CHEALI_CHARGER_ARCHITECTURE_GENERIC_STRING      "simulation"
+
+#endif /* HARDWARE_CONFIG_GENERIC_H_ */
@@ -0,0 +1,147 @@
+/*
+    cheali-charger - open source firmware for a variety of LiPo chargers
+    Copyright (C) 2013  Paweł Stawicki. All right reserved.
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include <string.h>
+#include "LcdModel.h"
+#include "Hardware.h"
+
+#define LCD_DDRAM_SIZE      0x80
+#define LCD_LINE1_ADDRESS   0x40
+
+namespace LcdModel {
+    uint8_t pins_;
+    bool eightBit_ = true;
+    bool secondNibble_;
+    uint8_t high_;
+    bool cgram_;
+    uint8_t address_;
+    char ddram_[LCD_DDRAM_SIZE];
+    uint32_t changes_;
+
+    void clear() {
+        memset(ddram_, ' ', sizeof(ddram_));
+        address_ = 0;
+        changes_++;
+    }
+
+    void command(uint8_t c) {
+        if(c & 0x80) {
+            cgram_ = false;
+            address_ = c & 0x7f;
+        } else if(c & 0x40) {
+            cgram_ = true;
+        } else if(c & 0x20) {
+            //function set: DL bit
+            eightBit_ = c & 0x10;
+            secondNibble_ = false;
+        } else if(c & 0x01) {
+            clear();
+        } else if(c & 0x02) {
+            address_ = 0;
+        }
+        //entry mode, display control and shift are not used by the firmware
+    }
+
+    void data(uint8_t c) {
+        if(cgram_)
+            return;
+        if(ddram_[address_] != char(c)) {
+            ddram_[address_] = c;
+            changes_++;
+        }
+        address_ = (address_ + 1) % LCD_DDRAM_SIZE;
+    }
+
+    void latch() {
+        uint8_t nibble = pins_ & 0xf;
+        bool rs = pins_ & 0x10;
+        uint8_t value;
+        if(eightBit_) {
+            value = nibble << 4;
+        } else if(!secondNibble_) {
+            high_ = nibble;
+            secondNibble_ = true;
+            return;
+        } else {
+            value = (high_ << 4) | nibble;
+            secondNibble_ = false;
+        }
+        if(rs) data(value);
+        else command(value);
+    }
+
+    void setPin(uint8_t bit, uint8_t value) {
+        if(value) pins_ |= bit;
+        else pins_ &= ~bit;
+    }
+} // namespace LcdModel
+
+void LcdModel::initialize()
+{
+    clear();
+}
+
+void LcdModel::pinChanged(uint8_t pin, uint8_t value)
+{
+    switch(pin) {
+    case LCD_D0_PIN:        setPin(0x01, value); break;
+    case LCD_D1_PIN:        setPin(0x02, value); break;
+    case LCD_D2_PIN:        setPin(0x04, value); break;
+    case LCD_D3_PIN:        setPin(0x08, value); break;
+    case LCD_RS_PIN:        setPin(0x10, value); break;
+    case LCD_ENABLE_PIN:
+        if(!value && (pins_ & 0x20))
+            latch();
+        setPin(0x20, value);
+        break;
+    }
+}
+
+void LcdModel::getLine(char * line, uint8_t nr)
+{
+    const char * src = &ddram_[nr ? LCD_LINE1_ADDRESS : 0];
+    for(uint8_t i = 0; i < LCD_COLUMNS; i++) {
+        char c = src[i];
+        line[i] = (c >= ' ' && c <= '~') ? c : '#';
+    }
+    line[LCD_COLUMNS] = 0;
+}
+
+bool LcdModel::contains(const char * text)
+{
+    char line[LCD_COLUMNS + 1];
+    for(uint8_t i = 0; i < LCD_LINES; i++) {
+        getLine(line, i);
+        if(strstr(line, text))
+            return true;
+    }
+    return false;
+}
+
+uint32_t LcdModel::getChanges()
+{
+    return changes_;
+}
+
+void LcdModel::print(FILE * f)
+{
+    char line[LCD_COLUMNS + 1];
+    for(uint8_t i = 0; i < LCD_LINES; i++) {
+        getLine(line, i);
+        fprintf(f, "|%s|\n", line);
+    }
+}
@@ -0,0 +1,41 @@
+/*
+    cheali-charger - open source firmware for a variety of LiPo chargers
+    Copyright (C) 2013  Paweł Stawicki. All right reserved.
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#ifndef LCD_MODEL_H_
+#define LCD_MODEL_H_
+
+#include <stdio.h>
+#include <stdint.h>
+
+/*
+ * HD44780 display on the LCD pins (4 bit interface, see LiquidCrystal),
+ * data is latched on the falling edge of ENABLE
+ */
+namespace LcdModel {
+    void initialize();
+    void pinChanged(uint8_t pin, uint8_t value);
+
+    //displayed text, characters outside of ASCII are shown as '#'
+    void getLine(char * line, uint8_t nr);
+    bool contains(const char * text);
+    //incremented on every visible change
+    uint32_t getChanges();
+
+    void print(FILE * f);
+}
+
+#endif /* LCD_MODEL_H_ */
@@ -0,0 +1,215 @@
+/*
+    cheali-charger - open source firmware for a variety of LiPo chargers
+    Copyright (C) 2013  Paweł Stawicki. All right reserved.
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include <stdio.h>
+#include <string.h>
+#include "Operator.h"
+#include "Simulator.h"
+#include "Simulation.h"
+#include "LcdModel.h"
+#include "Hardware.h"
+#include "Program.h"
+#include "AnalogInputs.h"
+#include "Serial.h"
+#include "Settings.h"
+
+#define OPERATOR_PERIOD_US          10000
+#define OPERATOR_MAX_COMMANDS       32
+#define OPERATOR_MAX_LINE           64
+#define OPERATOR_KEY_PRESS_US       300000
+#define OPERATOR_BOOT_TIMEOUT_US    60000000ULL
+#define OPERATOR_START_TIMEOUT_US   30000000ULL
+#define OPERATOR_STOP_RETRY_US      10000000ULL
+
+namespace Operator {
+    bool printLcd;
+    uint64_t maxTimeUs = 24*3600*1000000ULL;
+    ProgramData::Battery battery;
+    int uart = -1;
+    bool resume;
+
+    enum State { Booting, Commands, Starting, Running, Stopping };
+    State state_;
+    uint64_t stateTime_;
+
+    char commands_[OPERATOR_MAX_COMMANDS][OPERATOR_MAX_LINE];
+    uint8_t commandsCount_, next_;
+    bool waitingReply_;
+
+    char line_[OPERATOR_MAX_LINE];
+    uint8_t lineLength_;
+
+    uint8_t keys_;
+    uint64_t keysTime_;
+
+    uint32_t lcdChanges_;
+    uint64_t lcdTime_;
+    bool error_;
+
+    void setState(State s) {
+        state_ = s;
+        stateTime_ = Simulation::getMicroseconds();
+    }
+
+    uint64_t inState() {
+        return Simulation::getMicroseconds() - stateTime_;
+    }
+
+    void press(uint8_t keys) {
+        uint64_t now = Simulation::getMicroseconds();
+        //release the keys before the next press
+        if(now - keysTime_ < 2 * OPERATOR_KEY_PRESS_US)
+            return;
+        keys_ = keys;
+        keysTime_ = now;
+    }
+
+    void send(const char * line) {
+        Serial::receive(line);
+        Serial::receive("\n");
+    }
+
+    void lineReceived() {
+        //boot report, see: BootInfo.h
+        if(strncmp(line_, "#B;", 3) == 0 || strncmp(line_, "DISP:TEXT 'boot ", 16) == 0) {
+            if(state_ == Booting) {
+                if(uart >= 0)
+                    settings.UART = uart;
+                setState(Commands);
+            }
+        } else if(strcmp(line_, "#OK") == 0) {
+            waitingReply_ = false;
+        } else if(strncmp(line_, "#E", 2) == 0 && waitingReply_) {
+            char result[2 * OPERATOR_MAX_LINE];
+            snprintf(result, sizeof(result), "command \"%s\" rejected (%s)", commands_[next_ - 1], line_ + 1);
+            Simulator::finish(Simulator::CommandRejected, result);
+        }
+    }
+
+    void doLcd(uint64_t now) {
+        if(!printLcd || lcdChanges_ == LcdModel::getChanges() || now - lcdTime_ < 1000000)
+            return;
+        lcdChanges_ = LcdModel::getChanges();
+        lcdTime_ = now;
+        fprintf(stderr, "[%9.1fs]\n", now * 1e-6);
+        LcdModel::print(stderr);
+    }
+
+    void tick() {
+        uint64_t now = Simulation::getMicroseconds();
+        if(keys_ && now - keysTime_ >= OPERATOR_KEY_PRESS_US)
+            keys_ = BUTTON_NONE;
+        doLcd(now);
+
+        if(now >= maxTimeUs)
+            Simulator::finish(Simulator::TimeLimit, "time limit reached");
+
+        switch(state_) {
+        case Booting:
+            if(LcdModel::contains("eeprom reset") || LcdModel::contains("calibrate"))
+                press(BUTTON_START);
+            if(inState() > OPERATOR_BOOT_TIMEOUT_US)
+                Simulator::finish(Simulator::NotStarted, "no boot report, UART disabled?");
+            break;
+        case Commands:
+            if(waitingReply_)
+                break;
+            if(next_ < commandsCount_) {
+                send(commands_[next_++]);
+                waitingReply_ = true;
+            } else {
+                setState(Starting);
+            }
+            break;
+        case Starting:
+            //without --resume the "P" command answers "resume?"
+            if(resume && LcdModel::contains("resume?"))
+                press(BUTTON_START);
+            //the remote start skips the start info without warnings, the resumed program does not
+            if(resume && Program::programState == Program::Info)
+                press(BUTTON_START);
+            if(Program::programState == Program::InProgress) {
+                battery = ProgramData::battery;
+                setState(Running);
+            } else if(inState() > OPERATOR_START_TIMEOUT_US) {
+                if(Program::programState == Program::Info) {
+                    //a start info warning waits for the start button, e.g. -b cells= does not match -c
+                    char result[2 * OPERATOR_MAX_LINE];
+                    snprintf(result, sizeof(result), "program did not start, start info warning (cells: %u, balance port: %u)",
+                            unsigned(ProgramData::battery.cells), unsigned(AnalogInputs::getConnectedBalancePortCellsCount()));
+                    Simulator::finish(Simulator::NotStarted, result);
+                }
+                Simulator::finish(Simulator::NotStarted, "program did not start");
+            }
+            break;
+        case Running:
+            if(Program::programState == Program::Done) {
+                Simulator::finish(Simulator::Complete, "program stopped");
+            } else if(Program::programState == Program::InProgress) {
+                error_ = LcdModel::contains("Error:");
+                if(error_ || LcdModel::contains("complete:")) {
+                    send("X");
+                    setState(Stopping);
+                }
+            }
+            break;
+        case Stopping:
+            if(Program::programState == Program::Done) {
+                if(error_)
+                    Simulator::finish(Simulator::ProgramError, Program::stopReason ? Program::stopReason : "error");
+                else
+                    Simulator::finish(Simulator::Complete, "complete");
+            } else if(inState() > OPERATOR_STOP_RETRY_US) {
+                send("X");
+                setState(Stopping);
+            }
+            break;
+        }
+    }
+} // namespace Operator
+
+void Operator::addCommand(const char * line)
+{
+    if(commandsCount_ < OPERATOR_MAX_COMMANDS) {
+        strncpy(commands_[commandsCount_], line, OPERATOR_MAX_LINE - 1);
+        commandsCount_++;
+    }
+}
+
+void Operator::initialize()
+{
+    setState(Booting);
+    Serial::setListener(serialTransmitted);
+    Simulation::addInterrupt(tick, OPERATOR_PERIOD_US);
+}
+
+uint8_t Operator::getKeys()
+{
+    return keys_;
+}
+
+void Operator::serialTransmitted(uint8_t c)
+{
+    if(c == '\r' || c == '\n') {
+        line_[lineLength_] = 0;
+        if(lineLength_ > 0)
+            lineReceived();
+        lineLength_ = 0;
+    } else if(lineLength_ < OPERATOR_MAX_LINE - 1) {
+        line_[lineLength_++] = c;
+    }
+}
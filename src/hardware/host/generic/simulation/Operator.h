@@ -0,0 +1,51 @@
+/*
+    cheali-charger - open source firmware for a variety of LiPo chargers
+    Copyright (C) 2013  Paweł Stawicki. All right reserved.
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#ifndef OPERATOR_H_
+#define OPERATOR_H_
+
+#include <stdint.h>
+#include "ProgramData.h"
+
+/*
+ * the simulated user: confirms the boot screens with START, sends the serial
+ * commands (SerialCommand) after the boot report, answers "resume?" (--resume), stops the program
+ * when "complete:" or "Error:" is shown and ends the simulation
+ * when the program is done
+ */
+namespace Operator {
+    //print the LCD (at most once per virtual second)
+    extern bool printLcd;
+    //end of the simulation, virtual time
+    extern uint64_t maxTimeUs;
+    //Settings::UARTType set after boot, -1: keep the eeprom settings
+    extern int uart;
+    //answer "resume?" (SessionJournal::runResume()) with START, no serial commands are sent
+    extern bool resume;
+    //program data of the started program
+    extern ProgramData::Battery battery;
+
+    //sent one by one, the next after "#OK"
+    void addCommand(const char * line);
+
+    void initialize();
+    uint8_t getKeys();
+    //Serial listener
+    void serialTransmitted(uint8_t c);
+}
+
+#endif /* OPERATOR_H_ */
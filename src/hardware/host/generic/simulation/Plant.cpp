@@ -0,0 +1,158 @@
+/*
+    cheali-charger - open source firmware for a variety of LiPo chargers
+    Copyright (C) 2013  Paweł Stawicki. All right reserved.
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include <math.h>
+#include "Plant.h"
+#include "SMPS_PID.h"
+#include "AnalogInputsADC.h"
+#include "ProgramData.h"
+#include "Utils.h"
+
+//the discharger cannot pull more than the battery gives into this resistance
+#define PLANT_DISCHARGER_MIN_R  0.1
+
+namespace Plant {
+    Config config = {
+        12.0,       //Vin
+        BatteryModel::defaultPackConfig(),
+        0.030,      //Rwires
+        0.050,      //Rconverter
+        0.002,      //tauConverter
+        6.8,        //Rbalancer
+        true,       //balancePort
+    };
+    volatile Outputs outputs;
+
+    BatteryModel::Pack pack_;
+    double I_;
+    double Vout_;
+    double chargeAh_, energyWh_;
+    double maxCellVoltage_;
+    uint64_t lastUs_;
+    double converterDecayDt_, converterDecay_;
+
+    double converterVoltage() {
+        double m = double(outputs.smpsMV) / OUTPUT_PWM_PRECISION_PERIOD;
+        if(m <= 1)
+            return config.Vin * m;
+        return config.Vin / (2 - m);
+    }
+
+} // namespace Plant
+
+void Plant::initialize()
+{
+    STATIC_ASSERT(ProgramData::LAST_BATTERY_TYPE == BATTERY_MODEL_CHEMISTRIES);
+    if(config.pack.cells > MAX_BALANCE_CELLS)
+        config.pack.cells = MAX_BALANCE_CELLS;
+    pack_.init(config.pack);
+    I_ = 0;
+    chargeAh_ = energyWh_ = 0;
+    maxCellVoltage_ = 0;
+    lastUs_ = 0;
+    converterDecayDt_ = 0;
+    Vout_ = pack_.getVoltage();
+}
+
+void Plant::step(uint64_t us)
+{
+    double dt = (us - lastUs_) * 1e-6;
+    lastUs_ = us;
+    if(dt <= 0)
+        return;
+
+    double Vinternal = pack_.getInternalVoltage();
+    double R = pack_.getResistance() + config.Rwires;
+
+    double Iend = 0;
+    if(outputs.battery && outputs.charger) {
+        Iend = (converterVoltage() - Vinternal) / (config.Rconverter + R);
+        //diode: no current back into the converter
+        if(Iend < 0) Iend = 0;
+    } else if(outputs.battery && outputs.discharger) {
+        Iend = AnalogInputsADC::toValue(AnalogInputs::IdischargeSet, outputs.dischargerValue) / 1000;
+        double Imax = Vinternal / (R + PLANT_DISCHARGER_MIN_R);
+        if(Iend > Imax) Iend = Imax;
+        if(Iend < 0) Iend = 0;
+        Iend = -Iend;
+    }
+    if(dt != converterDecayDt_) {
+        converterDecayDt_ = dt;
+        converterDecay_ = exp(-dt / config.tauConverter);
+    }
+    I_ = Iend + (I_ - Iend) * converterDecay_;
+
+    pack_.step(I_, dt, config.balancePort ? outputs.balancer : 0, config.Rbalancer);
+    Vout_ = pack_.getVoltage() + I_ * config.Rwires;
+
+    chargeAh_ += I_ * dt / 3600;
+    energyWh_ += I_ * Vout_ * dt / 3600;
+    for(uint8_t c = 0; c < pack_.getCells(); c++) {
+        double v = pack_.getCell(c).getVoltage();
+        if(v > maxCellVoltage_) maxCellVoltage_ = v;
+    }
+}
+
+double Plant::getInput(AnalogInputs::Name name)
+{
+    switch(name) {
+    case AnalogInputs::Vout_plus_pin:
+        return Vout_ * 1000;
+    case AnalogInputs::Ismps:
+        return I_ > 0 ? I_ * 1000 : 0;
+    case AnalogInputs::Idischarge:
+        return I_ < 0 ? -I_ * 1000 : 0;
+    case AnalogInputs::Vin:
+        return config.Vin * 1000;
+    case AnalogInputs::Tintern:
+        return pack_.getAmbient() * 100;
+    case AnalogInputs::Textern:
+        return pack_.getTemperature() * 100;
+    default:
+        if(name > AnalogInputs::Vb0_pin && name <= AnalogInputs::Vb6_pin) {
+            uint8_t c = name - AnalogInputs::Vb1_pin;
+            if(config.balancePort && c < pack_.getCells())
+                return pack_.getCell(c).getVoltage() * 1000;
+        }
+        return 0;
+    }
+}
+
+double Plant::getCurrent()
+{
+    return I_;
+}
+
+const BatteryModel::Pack & Plant::getPack()
+{
+    return pack_;
+}
+
+double Plant::getChargeAh()
+{
+    return chargeAh_;
+}
+
+double Plant::getEnergyWh()
+{
+    return energyWh_;
+}
+
+double Plant::getMaxCellVoltage()
+{
+    return maxCellVoltage_;
+}
@@ -0,0 +1,71 @@
+/*
+    cheali-charger - open source firmware for a variety of LiPo chargers
+    Copyright (C) 2013  Paweł Stawicki. All right reserved.
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#ifndef PLANT_H_
+#define PLANT_H_
+
+#include <stdint.h>
+#include "AnalogInputs.h"
+#include "BatteryModel.h"
+
+/*
+ * the simulated power stage and battery
+ *
+ * SMPS: buck (MV <= period) / boost converter from Vin, the output current
+ * follows (Vconverter - Vbattery)/R with a first order lag, it never flows
+ * back into the converter.
+ * discharger: current source set by the discharger value.
+ * battery: BatteryModel::Pack.
+ */
+namespace Plant {
+    struct Config {
+        double Vin;             //V
+        BatteryModel::PackConfig pack;
+        double Rwires;          //ohm, leads and connectors
+        double Rconverter;      //ohm, SMPS output resistance
+        double tauConverter;    //s, SMPS current settling time constant
+        double Rbalancer;       //ohm, balancer bleed resistor
+        bool balancePort;       //balance port connected
+    };
+    extern Config config;
+
+    //charger outputs, written by the hardware:: functions
+    struct Outputs {
+        bool battery;
+        bool charger;
+        bool discharger;
+        uint16_t smpsMV;
+        uint16_t dischargerValue;
+        uint8_t balancer;
+    };
+    extern volatile Outputs outputs;
+
+    void initialize();
+    //advance the plant to the virtual time "us"
+    void step(uint64_t us);
+
+    //value seen by the analog input in firmware units (mV, mA, 0.01C)
+    double getInput(AnalogInputs::Name name);
+
+    double getCurrent();            //A, positive: charging
+    const BatteryModel::Pack & getPack();
+    double getChargeAh();           //charge delivered into the battery
+    double getEnergyWh();
+    double getMaxCellVoltage();     //highest cell voltage of the run
+}
+
+#endif /* PLANT_H_ */
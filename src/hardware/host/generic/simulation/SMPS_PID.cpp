@@ -0,0 +1,150 @@
+/*
+    cheali-charger - open source firmware for a variety of LiPo chargers
+    Copyright (C) 2013  Paweł Stawicki. All right reserved.
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "Hardware.h"
+#include "SMPS_PID.h"
+#include "AnalogInputs.h"
+#include "atomic.h"
+#include "Monitor.h"
+#include "Plant.h"
+#include "Simulation.h"
+
+namespace {
+    volatile uint16_t i_PID_setpoint;
+    volatile uint16_t i_PID_CutOffVoltage;
+    volatile long i_PID_MV;
+    volatile bool i_PID_enable;
+    uint64_t lastUpdateUs;
+}
+
+uint32_t SMPS_PID::updates;
+uint32_t SMPS_PID::periodMinUs = UINT32_MAX;
+uint32_t SMPS_PID::periodMaxUs;
+
+
+uint16_t hardware::getPIDValue()
+{
+    uint16_t v;
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+        v = i_PID_MV>>PID_MV_PRECISION;
+    }
+    return v;
+}
+
+
+void SMPS_PID::update()
+{
+    uint64_t now = Simulation::getMicroseconds();
+    if(updates++) {
+        uint32_t period = uint32_t(now - lastUpdateUs);
+        if(period < periodMinUs) periodMinUs = period;
+        if(period > periodMaxUs) periodMaxUs = period;
+    }
+    lastUpdateUs = now;
+
+    if(!i_PID_enable) return;
+    //if Vout is too high disable PID
+    if(AnalogInputs::getADCValue(AnalogInputs::Vout_plus_pin) >= i_PID_CutOffVoltage) {
+        hardware::setChargerOutput(false);
+        i_PID_enable = false;
+        Monitor::i_externalError = MONITOR_EXTERNAL_ERROR_BATTERY_DISCONNECTED;
+        return;
+    }
+
+    uint16_t PV = AnalogInputs::getADCValue(AnalogInputs::Ismps);
+    long error = i_PID_setpoint;
+    error -= PV;
+    i_PID_MV += error*SMPS_PID_GAIN;
+
+    if(i_PID_MV<0) i_PID_MV = 0;
+    if((uint32_t)i_PID_MV > MAX_PID_MV_PRECISION) {
+        i_PID_MV = MAX_PID_MV_PRECISION;
+    }
+
+    SMPS_PID::setPID_MV(i_PID_MV>>PID_MV_PRECISION);
+}
+
+void SMPS_PID::init(uint16_t Vin, uint16_t Vout)
+{
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+        i_PID_setpoint = 0;
+        if(Vout>Vin) {
+            i_PID_MV = OUTPUT_PWM_PRECISION_PERIOD;
+        } else {
+            i_PID_MV = 0;
+        }
+        i_PID_MV <<= PID_MV_PRECISION;
+        i_PID_enable = true;
+    }
+}
+
+void SMPS_PID::setPID_MV(uint16_t value) {
+    if(value > MAX_PID_MV)
+        value = MAX_PID_MV;
+    Plant::outputs.smpsMV = value;
+}
+
+void hardware::setVoutCutoff(AnalogInputs::ValueType v) {
+    if(v > MAX_CHARGE_V) {
+        v = MAX_CHARGE_V;
+    }
+    AnalogInputs::ValueType cutOff = AnalogInputs::reverseCalibrateValue(AnalogInputs::Vout_plus_pin, v);
+    if(cutOff > ANALOG_INPUTS_MAX_ADC_Vout_plus_pin) {
+        //extra limit if calibration is wrong
+        cutOff = ANALOG_INPUTS_MAX_ADC_Vout_plus_pin;
+    }
+
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+        i_PID_CutOffVoltage = cutOff;
+    }
+}
+
+void hardware::setChargerValue(uint16_t value)
+{
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+        i_PID_setpoint = value;
+    }
+}
+
+void hardware::setChargerOutput(bool enable)
+{
+    if(enable) setDischargerOutput(false);
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+        i_PID_enable = false;
+        Plant::outputs.smpsMV = 0;
+        Plant::outputs.charger = enable;
+    }
+    if(enable) {
+        SMPS_PID::init(AnalogInputs::getRealValue(AnalogInputs::Vin), AnalogInputs::getRealValue(AnalogInputs::Vout_plus_pin));
+    }
+}
+
+
+void hardware::setDischargerOutput(bool enable)
+{
+    if(enable) setChargerOutput(false);
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+        Plant::outputs.discharger = enable;
+    }
+}
+
+void hardware::setDischargerValue(uint16_t value)
+{
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+        Plant::outputs.dischargerValue = value;
+    }
+}
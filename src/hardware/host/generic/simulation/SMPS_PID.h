@@ -0,0 +1,53 @@
+/*
+    cheali-charger - open source firmware for a variety of LiPo chargers
+    Copyright (C) 2013  Paweł Stawicki. All right reserved.
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#ifndef SMPS_PID_H_
+#define SMPS_PID_H_
+
+#include "Hardware.h"
+
+//the same controller as on the nuvoton 50W, the "PWM" is Plant::outputs.smpsMV
+#define OUTPUT_PWM_PRECISION_PERIOD (780 * 42)
+
+//MV - manipulated variable in PID
+#ifndef MAX_PID_MV_FACTOR
+//D = MAX_PID_MV_FACTOR -1
+//Vout <= Vin/(1-D) = Vin/(2-MAX_PID_MV_FACTOR)
+#define MAX_PID_MV_FACTOR 1.5
+#endif
+
+//integral gain
+#ifndef SMPS_PID_GAIN
+#define SMPS_PID_GAIN 4
+#endif
+
+#define MAX_PID_MV ((uint16_t) (OUTPUT_PWM_PRECISION_PERIOD * MAX_PID_MV_FACTOR))
+#define PID_MV_PRECISION 8
+#define MAX_PID_MV_PRECISION (((uint32_t) MAX_PID_MV)<<PID_MV_PRECISION)
+
+namespace SMPS_PID
+{
+    void init(uint16_t Vin, uint16_t Vout);
+    void setPID_MV(uint16_t value);
+    void update();
+
+    //virtual time between the update() calls, for the simulator summary
+    extern uint32_t updates;
+    extern uint32_t periodMinUs, periodMaxUs;
+};
+
+#endif //SMPS_PID_H_
@@ -0,0 +1,402 @@
+/*
+    cheali-charger - open source firmware for a variety of LiPo chargers
+    Copyright (C) 2013  Paweł Stawicki. All right reserved.
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <stddef.h>
+#include <getopt.h>
+#include <time.h>
+#include "Simulator.h"
+#include "Simulation.h"
+#include "Operator.h"
+#include "Plant.h"
+#include "AnalogInputsADC.h"
+#include "Hardware.h"
+#include "Program.h"
+#include "ProgramData.h"
+#include "eeprom.h"
+#include "Serial.h"
+#include "Tuning.h"
+#include "Benchmark.h"
+#include "SMPS_PID.h"
+#include "SessionJournal.h"
+
+#define SIMULATOR_MAX_FIELDS    24
+#define SIMULATOR_MAX_LINE      32
+#ifdef ENABLE_SESSION_JOURNAL
+//the image is eeprom::data followed by the journal
+#define SIMULATOR_JOURNAL_SIZE  (SESSION_JOURNAL_SLOTS * sizeof(SessionJournal::Record))
+#endif
+
+int chealiMain();
+
+namespace eeprom {
+    extern uint32_t writtenBytes;
+}
+
+namespace Simulator {
+
+    struct Name {
+        const char * name;
+        int value;
+    };
+
+    const Name programs_[] = {
+        {"Charge",              Program::Charge},
+        {"ChargeBalance",       Program::ChargeBalance},
+        {"Balance",             Program::Balance},
+        {"Discharge",           Program::Discharge},
+        {"FastCharge",          Program::FastCharge},
+        {"Storage",             Program::Storage},
+        {"StorageBalance",      Program::StorageBalance},
+        {"DischargeChargeCycle",Program::DischargeChargeCycle},
+        {"CapacityCheck",       Program::CapacityCheck},
+        {0, 0}
+    };
+
+    const Name batteryTypes_[] = {
+        {"None",    ProgramData::NoneBatteryType},
+        {"NiCd",    ProgramData::NiCd},
+        {"NiMH",    ProgramData::NiMH},
+        {"Pb",      ProgramData::Pb},
+        {"Life",    ProgramData::Life},
+        {"Lilo",    ProgramData::Lilo},
+        {"Lipo",    ProgramData::Lipo},
+        {"Li430",   ProgramData::Li430},
+        {"Li435",   ProgramData::Li435},
+        {"NiZn",    ProgramData::NiZn},
+        {"Unknown", ProgramData::UnknownBatteryType},
+        {"LED",     ProgramData::LED},
+        {0, 0}
+    };
+
+    const Name uartTypes_[] = {
+        {"Normal",      Settings::Normal},
+        {"Debug",       Settings::Debug},
+        {"ExtDebug",    Settings::ExtDebug},
+        {"ExtDebugAdc", Settings::ExtDebugAdc},
+        {0, 0}
+    };
+
+#define BATTERY_FIELD(field) {#field, offsetof(ProgramData::Battery, field) / sizeof(uint16_t)}
+    //SerialCommand "W<field>=" numbers
+    const Name batteryFields_[] = {
+        BATTERY_FIELD(type),
+        BATTERY_FIELD(capacity),
+        BATTERY_FIELD(cells),
+        BATTERY_FIELD(Ic),
+        BATTERY_FIELD(Id),
+        BATTERY_FIELD(Vc_per_cell),
+        BATTERY_FIELD(Vd_per_cell),
+        BATTERY_FIELD(minIc),
+        BATTERY_FIELD(minId),
+        BATTERY_FIELD(time),
+        BATTERY_FIELD(enable_externT),
+        BATTERY_FIELD(externTCO),
+        BATTERY_FIELD(enable_adaptiveDischarge),
+        BATTERY_FIELD(DCRestTime),
+        BATTERY_FIELD(capCutoff),
+        BATTERY_FIELD(Vs_per_cell),
+        BATTERY_FIELD(balancerError),
+        BATTERY_FIELD(enable_deltaV),
+        BATTERY_FIELD(deltaV),
+        BATTERY_FIELD(deltaVIgnoreTime),
+        BATTERY_FIELD(deltaT),
+        BATTERY_FIELD(DCcycles),
+        {0, 0}
+    };
+
+    const char * eepromFile_;
+    const char * programName_;
+    bool csv_;
+    clock_t hostStart_;
+
+    bool find(const Name * names, const char * name, int &value) {
+        for(; names->name; names++) {
+            if(strcasecmp(names->name, name) == 0) {
+                value = names->value;
+                return true;
+            }
+        }
+        char * end;
+        value = strtol(name, &end, 0);
+        return *name && *end == 0;
+    }
+
+    void usage(const char * exe) {
+        fprintf(stderr,
+            "usage: %s [options]\n"
+            "runs the charger firmware against a simulated battery, faster than real time;\n"
+            "the serial log goes to stdout, the summary to stderr\n"
+            "  -p, --program NAME       Charge (default), ChargeBalance, Balance, Discharge, FastCharge,\n"
+            "                           Storage, StorageBalance, DischargeChargeCycle, CapacityCheck\n"
+            "  -s, --slot N             program data slot (default 0)\n"
+            "  -b, --battery FIELD=V    ProgramData::Battery field (type=Lipo, Ic=1000, Vc_per_cell=4150, ...)\n"
+            "  -c, --cells N            cells of the simulated battery (default 3)\n"
+            "  -C, --capacity MAH       capacity of the simulated battery (default 2200), also Ic (1C)\n"
+            "      --chemistry TYPE     battery model (default: the battery type)\n"
+            "      --soc PERCENT        initial state of charge (default 10)\n"
+            "      --capacity-spread PERCENT, --resistance-spread PERCENT, --soc-spread PERCENT\n"
+            "                           cell mismatch, standard deviation (default 0)\n"
+            "      --vin V              input voltage (default 12)\n"
+            "      --ambient C          ambient temperature (default 25)\n"
+            "      --no-balance-port    balance port not connected\n"
+            "      --noise LSB          ADC noise, rms 12bit LSB (default 0.5)\n"
+            "      --seed N             random seed of the ADC noise and the cell mismatch\n"
+            "      --cpu-us US          virtual time between interrupt points (default %u)\n"
+            "      --max-time S         virtual time limit (default 86400)\n"
+            "      --log FILE           serial output to FILE\n"
+            "      --eeprom FILE        load the eeprom image (if it exists), save it at the end,\n"
+            "                           the program data is saved to the slot\n"
+            "      --resume             resume the program of the session journal in the eeprom image\n"
+            "                           (no serial commands)\n"
+            "      --lcd                print the LCD to stderr\n"
+            "      --uart LEVEL         serial log: Normal (default), Debug, ExtDebug (+ channel 3 without BB3), ExtDebugAdc\n"
+            "  -t, --tune NAME=V        core constant:", exe, Simulation::cpuTimeUs);
+    Tuning::printNames(stderr);
+    fprintf(stderr, "\n"
+            "      --bench N            time N passes of the measurement + strategy instead (host cycles)\n"
+            "      --csv                summary as one line: result,time_s,charge_mAh,energy_Wh,\n"
+            "                           max_cell_V,overshoot_mV,cell_delta_mV,max_T\n");
+        exit(NotStarted);
+    }
+
+    void loadEeprom() {
+        memset(&eeprom::data, 0xff, sizeof(eeprom::data));
+#ifdef ENABLE_SESSION_JOURNAL
+        memset(SessionJournal::journal, 0xff, SIMULATOR_JOURNAL_SIZE);
+#endif
+        if(!eepromFile_)
+            return;
+        FILE * f = fopen(eepromFile_, "rb");
+        if(!f)
+            return;
+        if(fread(&eeprom::data, 1, sizeof(eeprom::data), f) != sizeof(eeprom::data))
+            fprintf(stderr, "%s: short eeprom image\n", eepromFile_);
+#ifdef ENABLE_SESSION_JOURNAL
+        //images without the journal: empty journal
+        if(fread(SessionJournal::journal, 1, SIMULATOR_JOURNAL_SIZE, f) != SIMULATOR_JOURNAL_SIZE)
+            memset(SessionJournal::journal, 0xff, SIMULATOR_JOURNAL_SIZE);
+#endif
+        fclose(f);
+    }
+
+    void saveEeprom() {
+        if(!eepromFile_)
+            return;
+        FILE * f = fopen(eepromFile_, "wb");
+        bool ok = f && fwrite(&eeprom::data, 1, sizeof(eeprom::data), f) == sizeof(eeprom::data);
+#ifdef ENABLE_SESSION_JOURNAL
+        ok = ok && fwrite(SessionJournal::journal, 1, SIMULATOR_JOURNAL_SIZE, f) == SIMULATOR_JOURNAL_SIZE;
+#endif
+        if(!ok)
+            fprintf(stderr, "%s: cannot write eeprom image\n", eepromFile_);
+        if(f)
+            fclose(f);
+    }
+
+    void printCsv(Result result, double virtualS) {
+        const BatteryModel::Pack &pack = Plant::getPack();
+        double Vmin = 1e9, Vmax = 0, Tmax = -1e9;
+        for(uint8_t c = 0; c < pack.getCells(); c++) {
+            const BatteryModel::Cell &cell = pack.getCell(c);
+            if(cell.getVoltage() < Vmin) Vmin = cell.getVoltage();
+            if(cell.getVoltage() > Vmax) Vmax = cell.getVoltage();
+            if(cell.getTemperature() > Tmax) Tmax = cell.getTemperature();
+        }
+        double overshoot = Plant::getMaxCellVoltage() * 1000 - Operator::battery.Vc_per_cell;
+        fprintf(stderr, "%d,%.1f,%.0f,%.3f,%.4f,%.1f,%.1f,%.1f\n", int(result), virtualS,
+                Plant::getChargeAh() * 1000, Plant::getEnergyWh(), Plant::getMaxCellVoltage(),
+                overshoot, (Vmax - Vmin) * 1000, Tmax);
+    }
+
+} // namespace Simulator
+
+void Simulator::finish(Result result, const char * description)
+{
+    double virtualS = Simulation::getMicroseconds() * 1e-6;
+    double hostS = double(clock() - hostStart_) / CLOCKS_PER_SEC;
+
+    fflush(stdout);
+    if(csv_) {
+        printCsv(result, virtualS);
+        saveEeprom();
+        exit(result);
+    }
+    fprintf(stderr, "%s: %s\n", programName_, description);
+    fprintf(stderr, "time: %.1f s virtual, %.2f s host", virtualS, hostS);
+    if(hostS > 0)
+        fprintf(stderr, " (x%.0f)", virtualS / hostS);
+    if(virtualS > 0)
+        fprintf(stderr, ", cpu sleep: %.1f%%", Simulation::idleUs * 1e-4 / virtualS);
+    fprintf(stderr, "\ncharge: %.0f mAh, %.2f Wh (battery), Cout: %.3f mAh, Eout: %.4f Wh (charger)\n",
+            Plant::getChargeAh() * 1000, Plant::getEnergyWh(),
+            AnalogInputs::getChargeMicroAh() / 1000.0, AnalogInputs::getEoutMicroWh() / 1e6);
+    const BatteryModel::Pack &pack = Plant::getPack();
+    fprintf(stderr, "cells (V/SoC/T):");
+    for(uint8_t c = 0; c < pack.getCells(); c++) {
+        const BatteryModel::Cell &cell = pack.getCell(c);
+        fprintf(stderr, " %.3f/%.1f%%/%.1fC", cell.getVoltage(), cell.getSoc() * 100, cell.getTemperature());
+    }
+    fprintf(stderr, "\nPID: %u updates, period: %u..%u us\n", unsigned(SMPS_PID::updates),
+            unsigned(SMPS_PID::updates > 1 ? SMPS_PID::periodMinUs : 0), unsigned(SMPS_PID::periodMaxUs));
+    fprintf(stderr, "eeprom: %u bytes written\n", unsigned(eeprom::writtenBytes));
+
+    saveEeprom();
+    exit(result);
+}
+
+int main(int argc, char * argv[])
+{
+    using namespace Simulator;
+    enum { SOC = 256, CHEMISTRY, CAPACITY_SPREAD, RESISTANCE_SPREAD, SOC_SPREAD, VIN, AMBIENT, NO_BALANCE_PORT, NOISE, SEED, CPU_US, MAX_TIME, LOG, EEPROM, RESUME, LCD, UART, CSV, BENCH };
+    static const option options[] = {
+        {"program",         required_argument,  0, 'p'},
+        {"slot",            required_argument,  0, 's'},
+        {"battery",         required_argument,  0, 'b'},
+        {"cells",           required_argument,  0, 'c'},
+        {"capacity",        required_argument,  0, 'C'},
+        {"soc",             required_argument,  0, SOC},
+        {"chemistry",       required_argument,  0, CHEMISTRY},
+        {"capacity-spread", required_argument,  0, CAPACITY_SPREAD},
+        {"resistance-spread", required_argument, 0, RESISTANCE_SPREAD},
+        {"soc-spread",      required_argument,  0, SOC_SPREAD},
+        {"vin",             required_argument,  0, VIN},
+        {"ambient",         required_argument,  0, AMBIENT},
+        {"no-balance-port", no_argument,        0, NO_BALANCE_PORT},
+        {"noise",           required_argument,  0, NOISE},
+        {"seed",            required_argument,  0, SEED},
+        {"cpu-us",          required_argument,  0, CPU_US},
+        {"max-time",        required_argument,  0, MAX_TIME},
+        {"log",             required_argument,  0, LOG},
+        {"eeprom",          required_argument,  0, EEPROM},
+        {"resume",          no_argument,        0, RESUME},
+        {"lcd",             no_argument,        0, LCD},
+        {"uart",            required_argument,  0, UART},
+        {"tune",            required_argument,  0, 't'},
+        {"csv",             no_argument,        0, CSV},
+        {"bench",           required_argument,  0, BENCH},
+        {"help",            no_argument,        0, 'h'},
+        {0, 0, 0, 0}
+    };
+
+    int program = Program::Charge;
+    int slot = 0;
+    int type = ProgramData::Lipo;
+    int chemistry = -1;
+    unsigned bench = 0;
+    const char * fields[SIMULATOR_MAX_FIELDS];
+    int fieldsCount = 0;
+    programName_ = "Charge";
+
+    int o;
+    while((o = getopt_long(argc, argv, "p:s:b:c:C:t:h", options, 0)) != -1) {
+        switch(o) {
+        case 'p':
+            if(!find(programs_, optarg, program)) usage(argv[0]);
+            programName_ = optarg;
+            break;
+        case 's':       slot = atoi(optarg); break;
+        case 'b':
+            if(strncasecmp(optarg, "type=", 5) == 0) {
+                if(!find(batteryTypes_, optarg + 5, type)) usage(argv[0]);
+            } else if(fieldsCount < SIMULATOR_MAX_FIELDS) {
+                fields[fieldsCount++] = optarg;
+            }
+            break;
+        case 'c':       Plant::config.pack.cells = atoi(optarg); break;
+        case 'C':       Plant::config.pack.capacity = atof(optarg) / 1000; break;
+        case CHEMISTRY:
+            if(!find(batteryTypes_, optarg, chemistry)) usage(argv[0]);
+            break;
+        case SOC:       Plant::config.pack.soc = atof(optarg) / 100; break;
+        case CAPACITY_SPREAD:   Plant::config.pack.capacitySpread = atof(optarg) / 100; break;
+        case RESISTANCE_SPREAD: Plant::config.pack.resistanceSpread = atof(optarg) / 100; break;
+        case SOC_SPREAD:        Plant::config.pack.socSpread = atof(optarg) / 100; break;
+        case VIN:       Plant::config.Vin = atof(optarg); break;
+        case AMBIENT:   Plant::config.pack.ambient = atof(optarg); break;
+        case NO_BALANCE_PORT: Plant::config.balancePort = false; break;
+        case NOISE:     AnalogInputsADC::noise = atof(optarg); break;
+        case SEED:
+            srand(atoi(optarg));
+            Plant::config.pack.seed = atoi(optarg);
+            break;
+        case CPU_US:    Simulation::cpuTimeUs = atoi(optarg); break;
+        case MAX_TIME:  Operator::maxTimeUs = uint64_t(atof(optarg) * 1e6); break;
+        case LOG:
+            if(!freopen(optarg, "w", stdout)) usage(argv[0]);
+            break;
+        case EEPROM:    eepromFile_ = optarg; break;
+        case RESUME:    Operator::resume = true; break;
+        case LCD:       Operator::printLcd = true; break;
+        case UART:
+            if(!find(uartTypes_, optarg, Operator::uart)) usage(argv[0]);
+            break;
+        case 't':
+            if(!Tuning::set(optarg)) usage(argv[0]);
+            break;
+        case CSV:       csv_ = true; break;
+        case BENCH:     bench = atoi(optarg); break;
+        default:        usage(argv[0]);
+        }
+    }
+    if(optind < argc)
+        usage(argv[0]);
+    Plant::config.pack.batteryType = chemistry < 0 ? type : chemistry;
+
+    if(bench) {
+        loadEeprom();
+        Benchmark::run(program, type, bench);
+    }
+
+    if(!Operator::resume) {
+        char line[SIMULATOR_MAX_LINE];
+        snprintf(line, sizeof(line), "L%d", slot);
+        Operator::addCommand(line);
+        snprintf(line, sizeof(line), "W0=%d", type);
+        Operator::addCommand(line);
+        snprintf(line, sizeof(line), "W%d=%d", int(offsetof(ProgramData::Battery, cells) / 2), Plant::config.pack.cells);
+        Operator::addCommand(line);
+        uint16_t capacity = uint16_t(Plant::config.pack.capacity * 1000 + 0.5);
+        snprintf(line, sizeof(line), "W%d=%u", int(offsetof(ProgramData::Battery, capacity) / 2), capacity);
+        Operator::addCommand(line);
+        snprintf(line, sizeof(line), "W%d=%u", int(offsetof(ProgramData::Battery, Ic) / 2), capacity);
+        Operator::addCommand(line);
+        for(int i = 0; i < fieldsCount; i++) {
+            const char * eq = strchr(fields[i], '=');
+            int field;
+            if(!eq || eq - fields[i] >= SIMULATOR_MAX_LINE) usage(argv[0]);
+            strncpy(line, fields[i], eq - fields[i]);
+            line[eq - fields[i]] = 0;
+            if(!find(batteryFields_, line, field)) usage(argv[0]);
+            snprintf(line, sizeof(line), "W%d=%s", field, eq + 1);
+            Operator::addCommand(line);
+        }
+        if(eepromFile_)
+            Operator::addCommand("S");
+        snprintf(line, sizeof(line), "P%d", program);
+        Operator::addCommand(line);
+    }
+
+    loadEeprom();
+    hostStart_ = clock();
+    Operator::initialize();
+    chealiMain();
+    return 0;
+}
@@ -0,0 +1,62 @@
+/*
+    cheali-charger - open source firmware for a variety of LiPo chargers
+    Copyright (C) 2013  Paweł Stawicki. All right reserved.
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include <stdlib.h>
+#include <string.h>
+#include "Tuning.h"
+
+namespace Tuning {
+    uint16_t smpsMaxCurrentChange = 200;
+    uint16_t stableValueError = 6;
+    uint16_t maxBalanceTime = 15;
+    uint16_t pidGain = 4;
+    uint16_t pidPeriodUs = 0;
+
+    struct Parameter {
+        const char * name;
+        uint16_t * value;
+    };
+
+    const Parameter parameters_[] = {
+        {"smpsMaxCurrentChange",    &smpsMaxCurrentChange},
+        {"stableValueError",        &stableValueError},
+        {"maxBalanceTime",          &maxBalanceTime},
+        {"pidGain",                 &pidGain},
+        {"pidPeriodUs",             &pidPeriodUs},
+        {0, 0}
+    };
+}
+
+bool Tuning::set(const char * assignment)
+{
+    const char * eq = strchr(assignment, '=');
+    if(!eq)
+        return false;
+    for(const Parameter * p = parameters_; p->name; p++) {
+        if(strlen(p->name) == size_t(eq - assignment) && strncmp(p->name, assignment, eq - assignment) == 0) {
+            *p->value = uint16_t(strtoul(eq + 1, 0, 0));
+            return true;
+        }
+    }
+    return false;
+}
+
+void Tuning::printNames(FILE * f)
+{
+    for(const Parameter * p = parameters_; p->name; p++)
+        fprintf(f, " %s=%u", p->name, unsigned(*p->value));
+}
@@ -0,0 +1,40 @@
+/*
+    cheali-charger - open source firmware for a variety of LiPo chargers
+    Copyright (C) 2013  Paweł Stawicki. All right reserved.
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#ifndef TUNING_H_
+#define TUNING_H_
+
+#include <stdint.h>
+#include <stdio.h>
+
+/*
+ * core constants which the simulation sets at run time (see: HardwareConfig.h),
+ * defaults: the values of the chargers
+ */
+namespace Tuning {
+    extern uint16_t smpsMaxCurrentChange;   //SMPS_MAX_CURRENT_CHANGE, mA
+    extern uint16_t stableValueError;       //ANALOG_INPUTS_STABLE_VALUE_ERROR
+    extern uint16_t maxBalanceTime;         //BALANCER_MAX_BALANCE_TIME, s
+    extern uint16_t pidGain;                //SMPS_PID_GAIN
+    extern uint16_t pidPeriodUs;            //SMPS_PID_PERIOD_US, 0: at the Ismps bursts
+
+    //"name=value", false: unknown name
+    bool set(const char * assignment);
+    void printNames(FILE * f);
+}
+
+#endif /* TUNING_H_ */
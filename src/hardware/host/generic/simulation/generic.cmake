@@ -0,0 +1,30 @@
+
+set(GENERIC_SOURCE
+    simulation.cpp
+    simulation.h
+    simulation-pins.h
+    SMPS_PID.h
+    SMPS_PID.cpp
+    AnalogInputsADC.cpp
+    AnalogInputsADC.h
+
+    Plant.cpp
+    Plant.h
+    LcdModel.cpp
+    LcdModel.h
+    Operator.cpp
+    Operator.h
+    Simulator.cpp
+    Simulator.h
+    Benchmark.cpp
+    Benchmark.h
+    Tuning.cpp
+    Tuning.h
+
+    Hardware.h
+    HardwareConfigGeneric.h
+)
+
+CHEALI_ADD(GENERIC_SOURCE_FILES "${GENERIC_SOURCE}")
+
+include(${CMAKE_CURRENT_LIST_DIR}/../../battery/battery.cmake)
@@ -0,0 +1,33 @@
+/*
+    cheali-charger - open source firmware for a variety of LiPo chargers
+    Copyright (C) 2013  Paweł Stawicki. All right reserved.
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#ifndef PINS_H_
+#define PINS_H_
+
+// virtual pins of the simulated board, only the LCD is connected through IO::
+// (see LcdModel), the power stage is set directly by the hardware:: functions
+
+#define LCD_D0_PIN                      1
+#define LCD_D1_PIN                      2
+#define LCD_D2_PIN                      3
+#define LCD_D3_PIN                      4
+#define LCD_ENABLE_PIN                  5
+#define LCD_RS_PIN                      6
+
+#define BUZZER_PIN                      7
+
+#endif /* PINS_H_ */
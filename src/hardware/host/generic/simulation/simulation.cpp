@@ -0,0 +1,89 @@
+/*
+    cheali-charger - open source firmware for a variety of LiPo chargers
+    Copyright (C) 2013  Paweł Stawicki. All right reserved.
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "simulation.h"
+#include "IO.h"
+#include "atomic.h"
+#include "LiquidCrystal.h"
+#include "Simulation.h"
+#include "LcdModel.h"
+#include "Operator.h"
+#include "Plant.h"
+
+#ifndef PINS_H_
+#error pins not defined (include *pins.h header in your HardwareConfig.h)
+#endif
+
+uint8_t hardware::getKeyPressed()
+{
+    return Operator::getKeys();
+}
+
+void hardware::setBalancerOutput(bool enable)
+{
+}
+
+void hardware::initializePins()
+{
+    setBalancer(0);
+    setBatteryOutput(false);
+    setBuzzer(0);
+
+    IO::pinMode(BUZZER_PIN, OUTPUT);
+}
+
+
+void hardware::initialize()
+{
+    LcdModel::initialize();
+    LiquidCrystal::init();
+    LiquidCrystal::begin(LCD_COLUMNS, LCD_LINES);
+    AnalogInputsADC::initialize();
+    setVoutCutoff(MAX_CHARGE_V);
+}
+
+void hardware::setBuzzer(uint8_t val)
+{
+    IO::digitalWrite(BUZZER_PIN, (val&1));
+}
+
+void hardware::setBatteryOutput(bool enable)
+{
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+        Plant::outputs.battery = enable;
+    }
+    if(!enable) {
+        setChargerOutput(false);
+        setDischargerOutput(false);
+    }
+}
+
+void hardware::setBalancer(uint8_t v)
+{
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+        Plant::outputs.balancer = v;
+    }
+}
+
+void hardware::setExternalTemperatueOutput(bool enable)
+{
+}
+
+void Simulation::pinChanged(uint8_t pin, uint8_t value)
+{
+    LcdModel::pinChanged(pin, value);
+}
@@ -0,0 +1,206 @@
+/*
+    cheali-charger - open source firmware for a variety of LiPo chargers
+    Copyright (C) 2013  Paweł Stawicki. All right reserved.
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/*
+ * cheali-pwm-model: the atmega32 Timer1 PWM modulator (PwmModulator.h, the
+ * same code as Timer1.cpp) driving a first order output filter (the power
+ * stage and the battery), sampled like the 50W atmega32 ADC: bursts of
+ * conversions, Ismps in 4 of 16 slots, full measurements of ROUNDS rounds.
+ *
+ * For every duty cycle it compares the modulator orders:
+ *  - ripple: rms of the filtered current around the ideal value,
+ *  - error: largest |full measurement - ideal| after settling,
+ *  - stable: time until 3 consecutive full measurements are within
+ *    STABLE_VALUE_ERROR (AnalogInputs::isStable()) after a step from 0.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <getopt.h>
+#include "PwmModulator.h"
+
+namespace {
+    unsigned period_ = 512;         //TIMER1_PERIOD (TOP)
+    double fc_ = 1000;              //output filter corner, Hz
+    double imax_ = 5000;            //current at 100% duty, mA
+    double adcUs_ = 52;             //ADC conversion, 250kHz ADC clock
+    unsigned burst_ = 14;           //ANALOG_INPUTS_ADC_BURST_COUNT
+    unsigned rounds_ = 58;          //ANALOG_INPUTS_ADC_ROUND_MAX_COUNT
+    double stableError_ = 6;        //ANALOG_INPUTS_STABLE_VALUE_ERROR, mA
+    double time_ = 10;              //virtual seconds per duty cycle
+    const unsigned SLOTS = 16, STABLE_MIN_VALUE = 3;
+
+    struct Result {
+        double ripple, error, stable;
+    };
+
+    template<uint8_t Order, uint8_t Precision>
+    Result run(uint16_t value) {
+        PwmModulator<Order, Precision> modulator;
+        const double pwmUs = (period_ + 1) / 16.0;
+        const double alpha = 1 - exp(-2 * M_PI * fc_ * pwmUs * 1e-6);
+        const double ideal = double(value) / (1 << Precision) / (period_ + 1) * imax_;
+        const double settleUs = 5e6 / (2 * M_PI * fc_);
+        const unsigned long periods = (unsigned long)(time_ * 1e6 / pwmUs);
+
+        double lc = 0, i = 0, nextConversion = 0, sum = 0, last = -1, rippleSum = 0;
+        unsigned long conversion = 0, rippleCount = 0;
+        unsigned samples = 0, round = 0, stableCount = 0;
+        Result r = {0, 0, -1};
+        for(unsigned long n = 0; n < periods; n++) {
+            double target = double(modulator.next(value)) / (period_ + 1) * imax_;
+            //the LC filter of the power stage: two poles at fc
+            lc += (target - lc) * alpha;
+            i += (lc - i) * alpha;
+            double now = (n + 1) * pwmUs;
+            if(now > settleUs) {
+                rippleSum += (i - ideal) * (i - ideal);
+                rippleCount++;
+            }
+            for(; nextConversion < now; nextConversion += adcUs_, conversion++) {
+                unsigned inBurst = conversion % burst_;
+                unsigned slot = (conversion / burst_) % SLOTS;
+                //the first conversions after a mux change are not used
+                if(slot % 4 == 3 && inBurst >= 2) {
+                    sum += i;
+                    samples++;
+                }
+                if(inBurst != burst_ - 1 || slot != SLOTS - 1 || ++round < rounds_)
+                    continue;
+                double measurement = sum / samples;
+                if(last >= 0 && fabs(measurement - last) <= stableError_)
+                    stableCount++;
+                else
+                    stableCount = 0;
+                if(stableCount >= STABLE_MIN_VALUE && r.stable < 0)
+                    r.stable = now * 1e-3;
+                if(now > settleUs && fabs(measurement - ideal) > r.error)
+                    r.error = fabs(measurement - ideal);
+                last = measurement;
+                sum = 0;
+                samples = round = 0;
+            }
+        }
+        r.ripple = rippleCount ? sqrt(rippleSum / rippleCount) : 0;
+        return r;
+    }
+
+    struct Summary {
+        double rippleMean, rippleMax, errorMax, stableMean, stableMax;
+        unsigned count, notStable;
+        Summary() : rippleMean(0), rippleMax(0), errorMax(0), stableMean(0), stableMax(0), count(0), notStable(0) {}
+        void add(const Result &r) {
+            count++;
+            rippleMean += r.ripple;
+            if(r.ripple > rippleMax) rippleMax = r.ripple;
+            if(r.error > errorMax) errorMax = r.error;
+            if(r.stable < 0) {
+                notStable++;
+                return;
+            }
+            stableMean += r.stable;
+            if(r.stable > stableMax) stableMax = r.stable;
+        }
+        void print(const char * name) {
+            unsigned stable = count - notStable;
+            printf("%-8s %9.3f %9.3f %9.3f %10.0f %10.0f %6u\n", name,
+                    rippleMean / count, rippleMax, errorMax,
+                    stable ? stableMean / stable : 0, stableMax, notStable);
+        }
+    };
+
+    void usage(const char * exe) {
+        fprintf(stderr, "usage: %s [options]\n"
+                "compares the first and second order PWM modulators (TIMER1_PRECISION 5)\n"
+                "  -f, --from V          first duty value, 1/32 of a timer step (default 1)\n"
+                "  -t, --to V            last duty value (default 640: 20 timer steps)\n"
+                "  -s, --step V          (default 1)\n"
+                "      --period N        TIMER1_PERIOD (default %u)\n"
+                "      --fc HZ           output filter corner (default %.0f)\n"
+                "      --imax MA         current at 100%% duty (default %.0f)\n"
+                "      --adc-us US       ADC conversion time (default %.0f)\n"
+                "      --burst N         conversions per burst (default %u)\n"
+                "      --rounds N        rounds per full measurement (default %u)\n"
+                "      --stable-error MA (default %.0f)\n"
+                "      --time S          virtual time per duty value (default %.0f)\n"
+                "  -v, --verbose         a line per duty value\n",
+                exe, period_, fc_, imax_, adcUs_, burst_, rounds_, stableError_, time_);
+        exit(1);
+    }
+}
+
+int main(int argc, char * argv[])
+{
+    enum { PERIOD = 256, FC, IMAX, ADC_US, BURST, ROUNDS, STABLE_ERROR, TIME };
+    static const option options[] = {
+        {"from",            required_argument,  0, 'f'},
+        {"to",              required_argument,  0, 't'},
+        {"step",            required_argument,  0, 's'},
+        {"period",          required_argument,  0, PERIOD},
+        {"fc",              required_argument,  0, FC},
+        {"imax",            required_argument,  0, IMAX},
+        {"adc-us",          required_argument,  0, ADC_US},
+        {"burst",           required_argument,  0, BURST},
+        {"rounds",          required_argument,  0, ROUNDS},
+        {"stable-error",    required_argument,  0, STABLE_ERROR},
+        {"time",            required_argument,  0, TIME},
+        {"verbose",         no_argument,        0, 'v'},
+        {"help",            no_argument,        0, 'h'},
+        {0, 0, 0, 0}
+    };
+    unsigned from = 1, to = 640, step = 1;
+    bool verbose = false;
+    int o;
+    while((o = getopt_long(argc, argv, "f:t:s:vh", options, 0)) != -1) {
+        switch(o) {
+        case 'f':           from = atoi(optarg); break;
+        case 't':           to = atoi(optarg); break;
+        case 's':           step = atoi(optarg); break;
+        case PERIOD:        period_ = atoi(optarg); break;
+        case FC:            fc_ = atof(optarg); break;
+        case IMAX:          imax_ = atof(optarg); break;
+        case ADC_US:        adcUs_ = atof(optarg); break;
+        case BURST:         burst_ = atoi(optarg); break;
+        case ROUNDS:        rounds_ = atoi(optarg); break;
+        case STABLE_ERROR:  stableError_ = atof(optarg); break;
+        case TIME:          time_ = atof(optarg); break;
+        case 'v':           verbose = true; break;
+        default:            usage(argv[0]);
+        }
+    }
+    if(optind < argc || step == 0 || burst_ < 3 || rounds_ == 0 || ((period_ + 4UL) << 5) > 0xffff)
+        usage(argv[0]);
+
+    Summary first, second;
+    if(verbose)
+        printf("value    ripple1   ripple2    error1    error2   stable1   stable2 (mA, ms)\n");
+    for(unsigned v = from; v <= to; v += step) {
+        Result r1 = run<1, 5>(v);
+        Result r2 = run<2, 5>(v);
+        first.add(r1);
+        second.add(r2);
+        if(verbose)
+            printf("%5u %9.3f %9.3f %9.3f %9.3f %9.0f %9.0f\n", v,
+                    r1.ripple, r2.ripple, r1.error, r2.error, r1.stable, r2.stable);
+    }
+    printf("order    ripple mean ripple max error max stable mean stable max not stable (mA, ms)\n");
+    first.print("1");
+    second.print("2");
+    return 0;
+}
@@ -0,0 +1,348 @@
+/*
+    cheali-charger - open source firmware for a variety of LiPo chargers
+    Copyright (C) 2013  Paweł Stawicki. All right reserved.
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/*
+ * cheali-sweep: runs cheali-charger-simulation over a grid of parameters and
+ * randomized packs on all cores and prints a summary per parameter set.
+ *
+ * The charger core keeps its state in namespace globals, so every run is a
+ * separate simulator process; the worker threads only start and collect them.
+ * Jobs are dealt to per-worker queues, an idle worker steals from the others.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <getopt.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <spawn.h>
+#include <sys/wait.h>
+#include <algorithm>
+#include <chrono>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+extern char **environ;
+
+#ifndef CHEALI_SWEEP_SIMULATOR
+#define CHEALI_SWEEP_SIMULATOR "cheali-charger-simulation"
+#endif
+
+namespace {
+
+    //Tuning.h parameters, anything else is a ProgramData::Battery field
+    const char * const tuneNames_[] = {
+        "smpsMaxCurrentChange", "stableValueError", "maxBalanceTime", "pidGain", 0
+    };
+
+    struct Parameter {
+        std::string name;
+        std::vector<std::string> values;
+    };
+
+    //cheali-charger-simulation --csv
+    struct Run {
+        unsigned set;
+        unsigned seed;
+        int result;
+        double time, charge, energy, maxCellV, overshoot, cellDelta, maxT;
+    };
+
+    struct Queue {
+        std::mutex mutex;
+        std::deque<unsigned> jobs;
+    };
+
+    const char * simulator_ = CHEALI_SWEEP_SIMULATOR;
+    std::vector<Parameter> parameters_;
+    std::vector<std::string> simulatorArgs_;
+    std::vector<Run> runs_;
+    unsigned packs_ = 20;
+    unsigned firstSeed_ = 1;
+    unsigned sets_;
+
+    Queue * queues_;
+    unsigned workers_;
+
+    bool isTuneName(const std::string &name) {
+        for(const char * const * n = tuneNames_; *n; n++)
+            if(name == *n) return true;
+        return false;
+    }
+
+    //value index of parameter p in the parameter set
+    unsigned valueIndex(unsigned set, size_t p) {
+        for(size_t i = parameters_.size() - 1; i > p; i--)
+            set /= parameters_[i].values.size();
+        return set % parameters_[p].values.size();
+    }
+
+    std::vector<std::string> arguments(const Run &run) {
+        std::vector<std::string> args;
+        args.push_back(simulator_);
+        args.push_back("--csv");
+        args.push_back("--seed");
+        args.push_back(std::to_string(run.seed));
+        args.insert(args.end(), simulatorArgs_.begin(), simulatorArgs_.end());
+        for(size_t p = 0; p < parameters_.size(); p++) {
+            args.push_back(isTuneName(parameters_[p].name) ? "-t" : "-b");
+            args.push_back(parameters_[p].name + "=" + parameters_[p].values[valueIndex(run.set, p)]);
+        }
+        return args;
+    }
+
+    void execute(Run &run) {
+        std::vector<std::string> args = arguments(run);
+        std::vector<char *> argv;
+        for(size_t i = 0; i < args.size(); i++)
+            argv.push_back(const_cast<char *>(args[i].c_str()));
+        argv.push_back(0);
+
+        run.result = -1;
+        int fd[2];
+        if(pipe(fd) != 0)
+            return;
+        posix_spawn_file_actions_t actions;
+        posix_spawn_file_actions_init(&actions);
+        posix_spawn_file_actions_addopen(&actions, 1, "/dev/null", O_WRONLY, 0);
+        posix_spawn_file_actions_adddup2(&actions, fd[1], 2);
+        posix_spawn_file_actions_addclose(&actions, fd[0]);
+        posix_spawn_file_actions_addclose(&actions, fd[1]);
+        pid_t pid;
+        int error = posix_spawn(&pid, simulator_, &actions, 0, &argv[0], environ);
+        posix_spawn_file_actions_destroy(&actions);
+        close(fd[1]);
+        if(error) {
+            close(fd[0]);
+            fprintf(stderr, "%s: %s\n", simulator_, strerror(error));
+            return;
+        }
+
+        std::string output;
+        char buffer[256];
+        ssize_t n;
+        while((n = read(fd[0], buffer, sizeof(buffer))) > 0)
+            output.append(buffer, n);
+        close(fd[0]);
+        int status;
+        waitpid(pid, &status, 0);
+
+        //the summary is the last line
+        size_t start = output.find_last_of('\n', output.size() >= 2 ? output.size() - 2 : 0);
+        start = start == std::string::npos ? 0 : start + 1;
+        if(sscanf(output.c_str() + start, "%d,%lf,%lf,%lf,%lf,%lf,%lf,%lf", &run.result, &run.time,
+                &run.charge, &run.energy, &run.maxCellV, &run.overshoot, &run.cellDelta, &run.maxT) != 8)
+            run.result = -1;
+    }
+
+    bool takeJob(unsigned worker, unsigned &job) {
+        for(unsigned i = 0; i < workers_; i++) {
+            Queue &q = queues_[(worker + i) % workers_];
+            std::lock_guard<std::mutex> lock(q.mutex);
+            if(q.jobs.empty())
+                continue;
+            //own queue from the front, steal from the back
+            if(i == 0) {
+                job = q.jobs.front();
+                q.jobs.pop_front();
+            } else {
+                job = q.jobs.back();
+                q.jobs.pop_back();
+            }
+            return true;
+        }
+        return false;
+    }
+
+    void worker(unsigned id) {
+        unsigned job;
+        while(takeJob(id, job))
+            execute(runs_[job]);
+    }
+
+    std::vector<std::string> split(const char * values) {
+        std::vector<std::string> v;
+        std::string s(values);
+        size_t start = 0, comma;
+        while((comma = s.find(',', start)) != std::string::npos) {
+            v.push_back(s.substr(start, comma - start));
+            start = comma + 1;
+        }
+        v.push_back(s.substr(start));
+        return v;
+    }
+
+    struct Stat {
+        double mean, max;
+    };
+
+    Stat stat(const std::vector<const Run *> &runs, double Run::*field) {
+        Stat s = {0, -1e9};
+        for(size_t i = 0; i < runs.size(); i++) {
+            s.mean += runs[i]->*field;
+            s.max = std::max(s.max, runs[i]->*field);
+        }
+        if(runs.empty())
+            s.max = 0;
+        else
+            s.mean /= runs.size();
+        return s;
+    }
+
+    void printSummary() {
+        for(size_t p = 0; p < parameters_.size(); p++)
+            printf("%-*s ", int(std::max<size_t>(parameters_[p].name.size(), 6)), parameters_[p].name.c_str());
+        printf("%5s %5s %17s %17s %17s %9s %7s\n", "runs", "fail",
+                "time min avg/max", "overshoot mV", "cell delta mV", "energy Wh", "max T");
+        for(unsigned set = 0; set < sets_; set++) {
+            std::vector<const Run *> ok;
+            unsigned failed = 0;
+            for(size_t i = 0; i < runs_.size(); i++) {
+                if(runs_[i].set != set)
+                    continue;
+                if(runs_[i].result == 0)
+                    ok.push_back(&runs_[i]);
+                else
+                    failed++;
+            }
+            for(size_t p = 0; p < parameters_.size(); p++)
+                printf("%-*s ", int(std::max<size_t>(parameters_[p].name.size(), 6)),
+                        parameters_[p].values[valueIndex(set, p)].c_str());
+            Stat time = stat(ok, &Run::time), overshoot = stat(ok, &Run::overshoot);
+            Stat delta = stat(ok, &Run::cellDelta), energy = stat(ok, &Run::energy), T = stat(ok, &Run::maxT);
+            printf("%5u %5u %8.1f/%-8.1f %8.1f/%-8.1f %8.1f/%-8.1f %9.2f %7.1f\n",
+                    unsigned(ok.size() + failed), failed, time.mean / 60, time.max / 60,
+                    overshoot.mean, overshoot.max, delta.mean, delta.max, energy.mean, T.max);
+        }
+    }
+
+    void saveRuns(const char * file) {
+        FILE * f = fopen(file, "w");
+        if(!f) {
+            fprintf(stderr, "%s: cannot write\n", file);
+            return;
+        }
+        for(size_t p = 0; p < parameters_.size(); p++)
+            fprintf(f, "%s,", parameters_[p].name.c_str());
+        fprintf(f, "seed,result,time_s,charge_mAh,energy_Wh,max_cell_V,overshoot_mV,cell_delta_mV,max_T\n");
+        for(size_t i = 0; i < runs_.size(); i++) {
+            const Run &r = runs_[i];
+            for(size_t p = 0; p < parameters_.size(); p++)
+                fprintf(f, "%s,", parameters_[p].values[valueIndex(r.set, p)].c_str());
+            fprintf(f, "%u,%d,%.1f,%.0f,%.3f,%.4f,%.1f,%.1f,%.1f\n", r.seed, r.result, r.time,
+                    r.charge, r.energy, r.maxCellV, r.overshoot, r.cellDelta, r.maxT);
+        }
+        fclose(f);
+    }
+
+    void usage(const char * exe) {
+        fprintf(stderr,
+            "usage: %s [options] [-- simulator options]\n"
+            "runs the simulator for every combination of the swept values and pack\n"
+            "  -x, --sweep NAME=V1,V2,..  swept value: smpsMaxCurrentChange, stableValueError,\n"
+            "                             maxBalanceTime, pidGain or a ProgramData::Battery field\n"
+            "  -n, --packs N              randomized packs (seeds) per combination (default 20)\n"
+            "      --seed N               first seed (default 1)\n"
+            "  -j, --jobs N               parallel simulations (default: hardware concurrency)\n"
+            "      --simulator PATH       (default %s)\n"
+            "      --runs FILE            every run as csv\n"
+            "simulator options are passed to every run, default:"
+            " --capacity-spread 3 --resistance-spread 10 --soc-spread 3\n",
+            exe, CHEALI_SWEEP_SIMULATOR);
+        exit(2);
+    }
+
+} // namespace
+
+int main(int argc, char * argv[])
+{
+    enum { SEED = 256, SIMULATOR, RUNS };
+    static const option options[] = {
+        {"sweep",       required_argument,  0, 'x'},
+        {"packs",       required_argument,  0, 'n'},
+        {"seed",        required_argument,  0, SEED},
+        {"jobs",        required_argument,  0, 'j'},
+        {"simulator",   required_argument,  0, SIMULATOR},
+        {"runs",        required_argument,  0, RUNS},
+        {"help",        no_argument,        0, 'h'},
+        {0, 0, 0, 0}
+    };
+
+    const char * runsFile = 0;
+    workers_ = std::max(1u, std::thread::hardware_concurrency());
+
+    int o;
+    while((o = getopt_long(argc, argv, "x:n:j:h", options, 0)) != -1) {
+        switch(o) {
+        case 'x': {
+            const char * eq = strchr(optarg, '=');
+            if(!eq || eq == optarg || !eq[1]) usage(argv[0]);
+            Parameter p;
+            p.name.assign(optarg, eq - optarg);
+            p.values = split(eq + 1);
+            parameters_.push_back(p);
+            break;
+        }
+        case 'n':       packs_ = atoi(optarg); break;
+        case SEED:      firstSeed_ = atoi(optarg); break;
+        case 'j':       workers_ = std::max(1, atoi(optarg)); break;
+        case SIMULATOR: simulator_ = optarg; break;
+        case RUNS:      runsFile = optarg; break;
+        default:        usage(argv[0]);
+        }
+    }
+    if(packs_ == 0)
+        usage(argv[0]);
+    const char * spreads[] = {"--capacity-spread", "3", "--resistance-spread", "10", "--soc-spread", "3"};
+    simulatorArgs_.assign(spreads, spreads + sizeof(spreads) / sizeof(spreads[0]));
+    simulatorArgs_.insert(simulatorArgs_.end(), argv + optind, argv + argc);
+
+    sets_ = 1;
+    for(size_t p = 0; p < parameters_.size(); p++)
+        sets_ *= parameters_[p].values.size();
+    for(unsigned set = 0; set < sets_; set++) {
+        for(unsigned i = 0; i < packs_; i++) {
+            Run r = Run();
+            r.set = set;
+            r.seed = firstSeed_ + i;
+            runs_.push_back(r);
+        }
+    }
+
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    queues_ = new Queue[workers_];
+    for(unsigned i = 0; i < runs_.size(); i++)
+        queues_[i % workers_].jobs.push_back(i);
+    std::vector<std::thread> threads;
+    for(unsigned i = 0; i < workers_; i++)
+        threads.push_back(std::thread(worker, i));
+    for(size_t i = 0; i < threads.size(); i++)
+        threads[i].join();
+    delete[] queues_;
+    double host = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    printf("%u runs, %u jobs, %.1f s\n", unsigned(runs_.size()), workers_, host);
+    printSummary();
+    if(runsFile)
+        saveRuns(runsFile);
+    return 0;
+}
@@ -0,0 +1,47 @@
+/*
+    cheali-charger - open source firmware for a variety of LiPo chargers
+    Copyright (C) 2013  Paweł Stawicki. All right reserved.
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#ifndef HARDWARE_CONFIG_H_
+#define HARDWARE_CONFIG_H_
+
+#include "GlobalConfig.h"
+#include "HardwareConfigGeneric.h"
+#include "simulation-pins.h"
+
+#define MAX_CHARGE_V            ANALOG_VOLT(27.000)
+#define MAX_CHARGE_I            ANALOG_AMP(6.000)
+#define MAX_CHARGE_P            ANALOG_WATT(80.000)
+
+#define MAX_DISCHARGE_P         ANALOG_WATT(10.000)
+#define MAX_DISCHARGE_I         ANALOG_AMP(2.000)
+
+//Ismps ADC value of 6.5A
+#define SMPS_UPPERBOUND_VALUE               53235
+#define DISCHARGER_UPPERBOUND_VALUE         32760
+
+//the simulator drives the charger through SerialCommand
+#define SETTINGS_UART_DEFAULT               Settings::Normal
+
+//set at run time (-t NAME=VALUE) for the parameter sweeps
+#include "Tuning.h"
+#define SMPS_MAX_CURRENT_CHANGE             Tuning::smpsMaxCurrentChange
+#define ANALOG_INPUTS_STABLE_VALUE_ERROR    Tuning::stableValueError
+#define BALANCER_MAX_BALANCE_TIME           Tuning::maxBalanceTime
+#define SMPS_PID_GAIN                       Tuning::pidGain
+#define SMPS_PID_PERIOD_US                  Tuning::pidPeriodUs
+
+#endif /* HARDWARE_CONFIG_H_ */
@@ -0,0 +1,49 @@
+/*
+    cheali-charger - open source firmware for a variety of LiPo chargers
+    Copyright (C) 2013  Paweł Stawicki. All right reserved.
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "AnalogInputsPrivate.h"
+#include "memory.h"
+#include "Utils.h"
+
+//ideal sensors, see: AnalogInputsADC::toADC()
+const AnalogInputs::DefaultValues AnalogInputs::inputsP_[] PROGMEM = {
+
+    {{0,  0},         {54600,  25000}},   //Vout_plus_pin
+    {{0,  0},         {54600,  25000}},   //Vout_minus_pin
+    {{0,  0},         {8190,  1000}},   //Ismps
+    {{0,  0},         {26208,  1000}},   //Idischarge
+
+    {{0,  0},         {1,  1}},   //VoutMux
+    {{0,  0},         {16380,  2500}},   //Tintern
+    {{0,  0},         {54600,  25000}},   //Vin
+    {{0,  0},         {16380,  2500}},   //Textern
+
+    {{0,  0},         {52416,  4000}},   //Vb0_pin
+    {{0,  0},         {52416,  4000}},   //Vb1_pin
+    {{0,  0},         {52416,  4000}},   //Vb2_pin
+    {{0,  0},         {52416,  4000}},   //Vb3_pin
+    {{0,  0},         {52416,  4000}},   //Vb4_pin
+    {{0,  0},         {52416,  4000}},   //Vb5_pin
+    {{0,  0},         {52416,  4000}},   //Vb6_pin
+
+
+    {{0,  0},         {8190,  1000}},   //IsmpsSet
+    {{0,  0},         {13104,  1000}},   //IdischargeSet
+};
+
+STATIC_ASSERT(sizeOfArray(AnalogInputs::inputsP_) == AnalogInputs::PHYSICAL_INPUTS);
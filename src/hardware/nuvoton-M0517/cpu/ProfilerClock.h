@@ -0,0 +1,57 @@
+/*
+    cheali-charger - open source firmware for a variety of LiPo chargers
+    Copyright (C) 2013  Paweł Stawicki. All right reserved.
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#ifndef PROFILERCLOCK_H_
+#define PROFILERCLOCK_H_
+
+extern "C" {
+#include "M051Series.h"
+}
+#include "atomic.h"
+#include "irq_priority.h"
+
+//SysTick counts HCLK cycles down from 2^24-1, it wraps every 0.34s at 50MHz,
+//its interrupts (overflows) extend it to 32 bits: 86s
+#define PROFILER_CLOCK_WRAP 0
+//HCLK: CLK_SetCoreClock(FREQ_50MHZ), see: cpu.cpp
+#define PROFILER_CLOCK_TICKS_PER_US 50
+
+namespace ProfilerClock {
+    //SysTick interrupts, see: Timer0.cpp
+    extern volatile uint8_t overflows;
+
+    inline void initialize() {
+        SysTick->LOAD = SysTick_LOAD_RELOAD_Msk;
+        SysTick->VAL = 0;
+        NVIC_SetPriority(SysTick_IRQn, PROFILER_CLOCK_IRQ_PRIORITY);
+        SysTick->CTRL = SysTick_CTRL_CLKSOURCE_Msk | SysTick_CTRL_TICKINT_Msk | SysTick_CTRL_ENABLE_Msk;
+    }
+
+    inline uint32_t get() {
+        uint32_t t, o;
+        ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+            t = SysTick_LOAD_RELOAD_Msk - SysTick->VAL;
+            o = overflows;
+            //overflow not handled yet (we are in an interrupt)
+            if((SCB->ICSR & SCB_ICSR_PENDSTSET_Msk) && t < SysTick_LOAD_RELOAD_Msk / 2)
+                o++;
+        }
+        return (o << 24) | t;
+    }
+}
+
+#endif /* PROFILERCLOCK_H_ */
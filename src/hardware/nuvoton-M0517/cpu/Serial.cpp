@@ -26,9 +26,7 @@
 #include "Screen.h"
 #include "sys.h"
 
-#ifdef ENABLE_TX_HW_SERIAL_PIN7_PIN38
 #include "TxHardSerial.h"
-#endif
 
 #include "TxSoftSerial.h"
 
@@ -47,6 +45,11 @@ uint8_t  txBuffer[Tx_BUFFER_SIZE];
 
 void  begin(unsigned long baud)
 {
+#ifdef ENABLE_SERIAL_COMMAND
+    //commands are received on UART0 (see: initialize) also with the software TX,
+    //at the speed of the serial log
+    UART0->BAUD = UART_BAUD_MODE2 | UART_BAUD_MODE2_DIVIDER(__HXT, baud);
+#endif
 #ifdef ENABLE_TX_HW_SERIAL_PIN7_PIN38
     if(settings.UARToutput == Settings::HardwarePin7 || settings.UARToutput == Settings::HardwarePin38) {
         write = &(TxHardSerial::write);
@@ -68,6 +71,12 @@ void  begin(unsigned long baud)
 };
 
 
+int read()
+{
+    //UART0 receives independently of the selected transmit output
+    return TxHardSerial::read();
+}
+
 void  initialize() {
 #ifdef ENABLE_TX_HW_SERIAL_PIN7_PIN38
     TxHardSerial::initialize();
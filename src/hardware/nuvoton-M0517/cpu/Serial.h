@@ -28,6 +28,7 @@ namespace Serial {
     extern void (*flush)();
     extern void (*end)();
     void  initialize();
+    int   read();
     extern uint8_t txBuffer[];
 } // namespace Serial
 
@@ -33,6 +33,19 @@ void TMR0_IRQHandler(void)
 }
 }
 
+#ifdef ENABLE_ISR_PROFILER
+#include "ProfilerClock.h"
+
+volatile uint8_t ProfilerClock::overflows;
+
+extern "C" {
+void SysTick_Handler(void)
+{
+    ProfilerClock::overflows++;
+}
+}
+#endif
+
 
 void Time::initialize()
 {
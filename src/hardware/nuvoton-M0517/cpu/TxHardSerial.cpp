@@ -27,6 +27,8 @@
 #include "Screen.h"
 
 #include "IO.h"
+#include "atomic.h"
+#include "IsrProfiler.h"
 
 # if defined ( __GNUC__ )
 #define RXBUFSIZE 32
@@ -70,7 +72,11 @@ void begin(unsigned long baud)
     /* Configure UART0 and set UART0 Baudrate */
     UART0->BAUD = UART_BAUD_MODE2 | UART_BAUD_MODE2_DIVIDER(__HXT, baud);
     UART0->LCR = UART_WORD_LEN_8 | UART_PARITY_NONE | UART_STOP_BIT_1;
+#ifdef ENABLE_SERIAL_COMMAND
+    UART0->IER = UART_IER_THRE_IEN_Msk | UART_IER_RDA_IEN_Msk | UART_IER_RTO_IEN_Msk;
+#else
     UART0->IER = UART_IER_THRE_IEN_Msk;
+#endif
 
     NVIC_SetPriority(UART0_IRQn,HARDWARE_SERIAL_IRQ_PRIORITY);
 }
@@ -94,6 +100,19 @@ void flush()
     while((UART0->FSR & UART_FSR_TE_FLAG_Msk) == 0);
 }
 
+int read()
+{
+    int c = -1;
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+        if(g_u32comRbytes > 0) {
+            c = g_u8RecData[g_u32comRhead];
+            g_u32comRhead = (g_u32comRhead == (RXBUFSIZE - 1)) ? 0 : (g_u32comRhead + 1);
+            g_u32comRbytes--;
+        }
+    }
+    return c;
+}
+
 void end()
 {
 //    NVIC_DisableIRQ(UART0_IRQn);
@@ -103,6 +122,7 @@ void end()
 extern "C"
 {
 void UART0_IRQHandler(void) {
+    IsrProfiler::Scope profile(IsrProfiler::UartIsr);
     uint16_t i = tail_.load(std::memory_order_relaxed);
     NVIC_DisableIRQ(UART0_IRQn);
     uint8_t u8InChar = 0xFF;
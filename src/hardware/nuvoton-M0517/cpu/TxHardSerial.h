@@ -27,6 +27,7 @@ namespace TxHardSerial {
     void  flush();
     void  end();
     void  initialize();
+    int   read();
 } // namespace TxHardSerial
 
 #endif //  TxHardSerial_H_
@@ -25,6 +25,7 @@
 #include "Serial.h"
 
 #include "IO.h"
+#include "IsrProfiler.h"
 
 namespace TxSoftSerial {
 
@@ -115,6 +116,7 @@ inline void getNewData() {
 extern "C"
 {
 void TMR2_IRQHandler(void) {
+    IsrProfiler::Scope profile(IsrProfiler::UartIsr);
     if(txData_) {
         *(txPin_) = txData_ & 1;
         txData_ >>= 1;
@@ -53,5 +53,10 @@ namespace cpu {
 
         SYS_LockReg();
     }
+
+    void idle() {
+        //SLEEPDEEP is not set: sleep mode, not power-down
+        __WFI();
+    }
 }
 
@@ -20,6 +20,8 @@
 
 namespace cpu {
     void init();
+    //sleep until the next interrupt, timers, ADC and UART keep running
+    void idle();
 }
 
 #endif /* CPU_H_ */
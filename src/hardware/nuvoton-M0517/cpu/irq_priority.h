@@ -23,8 +23,9 @@
 #define TIMER_IRQ_PRIORITY              2
 #define HARDWARE_SERIAL_IRQ_PRIORITY    3
 #define ADC_IRQ_PRIORITY                2
-#define ADC_C_DISCHARGE_IRQ_PRIORITY    2
+#define SMPS_PID_IRQ_PRIORITY           2
 #define OUTPUT_PWM_IRQ_PRIORITY         1
+#define PROFILER_CLOCK_IRQ_PRIORITY     3
 
 
 #endif /* IRQ_PRIORITY_H_ */
@@ -20,8 +20,8 @@
 #include "M051Series.h"
 #include "atomic.h"
 
-#define PAGE_SIZE         512
-#define PAGE_SIZE_32B     128
+#define PAGE_SIZE         EEPROM_ERASE_PAGE_SIZE
+#define PAGE_SIZE_32B     (PAGE_SIZE / 4)
 
 
 namespace eeprom {
@@ -46,9 +46,22 @@ void write_impl_less(uint8_t * addressE, const uint8_t * data, int size)
     if (ok)
         return;
 
+    //erased words are programmed without the page erase
+    int first = (p_adr_pos - (uint8_t*)buf) / 4;
+    int last = (p_adr_pos + size - 1 - (uint8_t*)buf) / 4;
+    bool erased = true;
+    for(i=first; i<=last; i++) {
+        erased = erased && buf[i] == 0xffffffff;
+    }
+
     for(i=0; i<size; i++)
         p_adr_pos[i] = ((uint8_t*)data)[i];
 
+    if (erased) {
+        for(i = first; i <= last; i++)
+            FMC_Write((uint32_t)&p_adr_start[i], buf[i]);
+        return;
+    }
 
     // Erase page
     while(FMC_Erase((uint32_t)p_adr_start));
@@ -88,5 +101,16 @@ void write_impl(uint8_t * addressE, const uint8_t * data, int size)
     } // enable interrupts
 }
 
+void erasePage(void * addressE)
+{
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+        SYS_UnlockReg();
+        FMC_Open();
+        while(FMC_Erase(((uint32_t)addressE) & (~(PAGE_SIZE - 1))));
+        FMC_Close();
+        SYS_LockReg();
+    }
+}
+
 } // namespace eeprom
 
@@ -24,6 +24,11 @@
 #define PSTR(x) x
 #define PROGMEM
 #define EEMEM __attribute__((section(".data_flash")))
+//data flash page, write_impl() erases it unless the written words are erased
+#define EEPROM_ERASE_PAGE_SIZE 512
+//the 4kB data flash (rom1 in CoIDE/arm-gcc-link.ld), E2END as in avr/io.h
+#define EEPROM_START 0x1f000
+#define E2END 0x1ffff
 
 namespace pgm {
 
@@ -53,6 +58,8 @@ namespace pgm {
 namespace eeprom {
 
     void write_impl(uint8_t * addressE, const uint8_t * data, int size);
+    //erases the page of addressE (all bytes 0xff)
+    void erasePage(void * addressE);
 
     template<class Type>
     static Type read(const Type * addressE) {
@@ -28,17 +28,21 @@
 #include "SMPS.h"
 #include "Discharger.h"
 #include "irq_priority.h"
+#include "IsrProfiler.h"
+#include "Monitor.h"
 
 #include "adc.h"
 
 /* ADC - measurement:
- * uses Timer1 to discharge Multiplexer Capacitor
+ * the ADC runs in burst mode, the FIFO interrupt (ADF) comes after every
+ * ADC_FIFO_SAMPLES conversions, the first one of a burst also ends
+ * the Multiplexer Capacitor discharge (the M051 has no PDMA)
  * program flow:
  *     ADC routine                          |  multiplexer routine
  * -----------------------------------------------------------------------------
  * start ADC (no MUX) conversion            |  1. switch MUX to op-amp (cell 6)
- *                                          |  2. start discharging C_adc (MUX capacitor), start Timer1
- *                                          |  3. wait 20us (timer1 50kHz)
+ *                                          |  2. start discharging C_adc (MUX capacitor)
+ *                                          |  3. wait for the first ADF (>= 20us)
  *                                          |  4. switch to MUX desired output, stop disch. C_adc
  *                                          |  (wait - for C_adc to charge)
  *                                          |
@@ -64,15 +68,24 @@
 #define ADC_CAPACITOR_DISCHARGE_ADDRESS MADDR_V_BALANSER6
 #define ADC_CAPACITOR_DISCHARGE_DELAY_US 20
 #define ADC_CLOCK_FREQUENCY 4000000UL
+//M051 datasheet: a conversion takes 27 ADC clocks, ADF is set after more than 4 samples
+#define ADC_CONVERSION_CLOCKS 27
+#define ADC_FIFO_SAMPLES 5
+//consecutive conversions over the limit before the comparator trips
+#define ADC_LIMIT_MATCH_COUNT 4
 
+STATIC_ASSERT(ADC_FIFO_SAMPLES * ADC_CONVERSION_CLOCKS * 1000000UL / ADC_CLOCK_FREQUENCY >= ADC_CAPACITOR_DISCHARGE_DELAY_US);
 
 
 volatile uint8_t g_adcBurstCount = 0;
 volatile uint8_t g_adcInputName = 0;
-volatile uint8_t g_muxAddress = 0;
+volatile int8_t g_muxAddress = -1;
 volatile uint8_t g_addSumToInput = 0;
 volatile uint32_t g_adcSum = 0;
 volatile uint32_t g_adcValue = 0;
+//ADCMPR values and the inputs they are used for (in their bursts only, AIN7 is shared)
+volatile uint32_t g_limitCmp[2];
+volatile uint8_t g_limitName[2];
 
 
 
@@ -141,22 +154,80 @@ void setMuxAddressAndDischarge(int8_t address)
         _setMuxAddress(ADC_CAPACITOR_DISCHARGE_ADDRESS);
         IO::disableFuncADC(IO::getADCChannel(MUX0_Z_D_PIN));
     }
-    TIMER_Start(TIMER1);             /* Start counting */
 }
-extern "C" {
-void TMR1_IRQHandler(void)
-{
-    /* Clear Timer1 time-out interrupt flag */
-    TIMER_ClearIntFlag(TIMER1);
 
+//called from the first ADC interrupt of a burst
+inline void endMuxDischarge()
+{
+    if(g_muxAddress < 0)
+        return;
     ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
         _setMuxAddress(g_muxAddress);
         //stop mux ADC C discharge
         IO::enableFuncADC(IO::getADCChannel(MUX0_Z_D_PIN));
     }
+    g_muxAddress = -1;
+}
+
+
+uint32_t limitCmp(uint8_t pin, uint16_t max)
+{
+    return ADC_ADCMPR_CMPCH(IO::getADCChannel(pin)) | ADC_ADCMPR_CMPCOND_GREATER_OR_EQUAL
+            | ADC_ADCMPR_CMPD(max >> 4) | ADC_ADCMPR_CMPMATCNT(ADC_LIMIT_MATCH_COUNT)
+            | ADC_ADCMPR_CMPIE_INTERRUPT_ENABLE | ADC_ADCMPR_CMPEN_Msk;
+}
+
+void setLimits(uint16_t voutPlusMax, AnalogInputs::Name current, uint16_t currentMax)
+{
+    uint8_t currentPin = current == AnalogInputs::Ismps ? SMPS_CURRENT_PIN : DISCHARGE_CURRENT_PIN;
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+        g_limitName[0] = AnalogInputs::Vout_plus_pin;
+        g_limitCmp[0] = limitCmp(OUTPUT_VOLTAGE_PLUS_PIN, voutPlusMax);
+        g_limitName[1] = current;
+        g_limitCmp[1] = limitCmp(currentPin, currentMax);
+    }
+}
+
+void disableLimits()
+{
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+        g_limitCmp[0] = g_limitCmp[1] = 0;
+        ADC_DISABLE_CMP0(ADC);
+        ADC_DISABLE_CMP1(ADC);
+    }
+}
+
+void limitTrip(uint32_t flags)
+{
+    disableLimits();
+    hardware::setChargerOutput(false);
+    hardware::setDischargerOutput(false);
+    Monitor::i_externalError = (flags & ADC_CMP0_INT) ? MONITOR_EXTERNAL_ERROR_BATTERY_DISCONNECTED
+            : MONITOR_EXTERNAL_ERROR_OUTPUT_CURRENT_TO_HIGH;
+}
+
+#ifdef SMPS_PID_PERIOD_US
+//the same priority as the ADC: i_adc_ is not changed during update()
+extern "C" {
+void TMR1_IRQHandler(void)
+{
+    IsrProfiler::Scope profile(IsrProfiler::PidIsr);
+    TIMER_ClearIntFlag(TIMER1);
+    SMPS_PID::update();
 }
 } //extern "C"
 
+void initializePidTimer()
+{
+    CLK_EnableModuleClock(TMR1_MODULE);
+    CLK_SetModuleClock(TMR1_MODULE, CLK_CLKSEL1_TMR1_S_HCLK, CLK_CLKDIV_UART(1));
+    TIMER_Open(TIMER1, TIMER_PERIODIC_MODE, 1000000 / SMPS_PID_PERIOD_US);
+    TIMER_EnableInt(TIMER1);
+    NVIC_EnableIRQ(TMR1_IRQn);
+    NVIC_SetPriority(TMR1_IRQn, SMPS_PID_IRQ_PRIORITY);
+    TIMER_Start(TIMER1);
+}
+#endif
 
 void initialize()
 {
@@ -176,15 +247,6 @@ void initialize()
     //initialize internal temperature sensor
     SYS->TEMPCR |= 1;
 
-    //initialize TIMER 1 (mux ADC capacitor discharge)
-    CLK_EnableModuleClock(TMR1_MODULE);
-    CLK_SetModuleClock(TMR1_MODULE,CLK_CLKSEL1_TMR1_S_HCLK,CLK_CLKDIV_UART(1));
-    //TODO: 50kHz ??
-    TIMER_Open(TIMER1, TIMER_ONESHOT_MODE, 1000000 / ADC_CAPACITOR_DISCHARGE_DELAY_US);
-    TIMER_EnableInt(TIMER1);
-    NVIC_EnableIRQ(TMR1_IRQn);
-    NVIC_SetPriority(TMR1_IRQn, ADC_C_DISCHARGE_IRQ_PRIORITY);
-
     //initialize ADC
     //init clock
     CLK_EnableModuleClock(ADC_MODULE);
@@ -208,6 +270,9 @@ void initialize()
 
     current_input_ = 0;
     startConversion();
+#ifdef SMPS_PID_PERIOD_US
+    initializePidTimer();
+#endif
 }
 
 void setNextMuxAddress()
@@ -224,6 +289,8 @@ void startConversion()
     setNextMuxAddress();
 
     g_adcInputName = order_analogInputs_on[current_input_].ai_name_;
+    ADC->ADCMPR[0] = g_limitName[0] == g_adcInputName ? g_limitCmp[0] : 0;
+    ADC->ADCMPR[1] = g_limitName[1] == g_adcInputName ? g_limitCmp[1] : 0;
     g_adcBurstCount = 0;
     g_adcSum = 0;
     uint8_t adc_pin = order_analogInputs_on[current_input_].adc_pin_;
@@ -256,8 +323,10 @@ void conversionDone()
     }
     startConversion();
 
+#ifndef SMPS_PID_PERIOD_US
     if(order_analogInputs_on[current_input_].trigger_PID_)
         SMPS_PID::update();
+#endif
 
 
 }
@@ -266,6 +335,7 @@ void finalizeMeasurement()
 {
     AnalogInputs::i_adc_[AnalogInputs::IsmpsSet]        = SMPS::getValue();
     AnalogInputs::i_adc_[AnalogInputs::IdischargeSet]   = Discharger::getValue();
+    AnalogInputs::intterruptIntegrate();
 
     if(g_addSumToInput) {
         AnalogInputs::i_avrSum_[AnalogInputs::IsmpsSet]        += SMPS::getValue() * ANALOG_INPUTS_ADC_BURST_COUNT;
@@ -290,6 +360,13 @@ extern "C" {
 
     void ADC_IRQHandler(void)
     {
+        IsrProfiler::Scope profile(IsrProfiler::AdcIsr);
+        AnalogInputsADC::endMuxDischarge();
+        uint32_t limits = ADC_GET_INT_FLAG(ADC, ADC_CMP0_INT | ADC_CMP1_INT);
+        if(limits) {
+            AnalogInputsADC::limitTrip(limits);
+            ADC_CLR_INT_FLAG(ADC, limits);
+        }
         while(ADC_IS_DATA_VALID2(ADC, 0)) /* Check the VALID bits */
         {
             /* In burst mode, the software always gets the conversion result of the specified channel from channel 0 */
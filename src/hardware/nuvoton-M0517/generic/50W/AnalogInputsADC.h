@@ -18,9 +18,16 @@
 #ifndef ANALOG_INPUTS_ADC_H_
 #define ANALOG_INPUTS_ADC_H_
 
+#include "AnalogInputs.h"
+
 namespace AnalogInputsADC
 {
     void initialize();
+
+    //ADC digital comparators: a match (during the bursts of the input) disables
+    //the outputs in the ADC interrupt, values as AnalogInputs::getADCValue()
+    void setLimits(uint16_t voutPlusMax, AnalogInputs::Name current, uint16_t currentMax);
+    void disableLimits();
 };
 
 #endif /* ANALOG_INPUTS_ADC_H_ */
@@ -44,6 +44,8 @@
 #define ENABLE_GET_PID_VALUE
 #define ENABLE_EXPERT_VOLTAGE_CALIBRATION
 #define ENABLE_T_INTERNAL
+//SMPS_PID::update() from TIMER1 (the latest Ismps burst value), default: at the Ismps bursts
+//#define SMPS_PID_PERIOD_US 1000
 
 #define DEFAULT_SETTINGS_EXTERNAL_T 0
 
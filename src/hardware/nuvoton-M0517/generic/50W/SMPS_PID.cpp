@@ -12,6 +12,23 @@ namespace {
     volatile uint16_t i_PID_CutOffVoltage;
     volatile long i_PID_MV;
     volatile bool i_PID_enable;
+
+    //ADC comparator limits while an output is on, see: AnalogInputsADC::setLimits()
+    uint16_t IsmpsCutOff_ = 0xffff;
+    uint16_t IdischargeCutOff_ = 0xffff;
+    bool limitsOn_;
+    AnalogInputs::Name limitsCurrent_;
+
+    void setLimits(bool on, AnalogInputs::Name current) {
+        limitsOn_ = on;
+        limitsCurrent_ = current;
+        if(!on) {
+            AnalogInputsADC::disableLimits();
+            return;
+        }
+        uint16_t max = current == AnalogInputs::Ismps ? IsmpsCutOff_ : IdischargeCutOff_;
+        AnalogInputsADC::setLimits(i_PID_CutOffVoltage, current, max);
+    }
 }
 
 #define A 4
@@ -109,6 +126,15 @@ void hardware::setVoutCutoff(AnalogInputs::ValueType v) {
     ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
         i_PID_CutOffVoltage = cutOff;
     }
+    if(limitsOn_)
+        setLimits(true, limitsCurrent_);
+}
+
+void hardware::setIoutCutoff(AnalogInputs::ValueType I) {
+    IsmpsCutOff_ = AnalogInputs::reverseCalibrateValue(AnalogInputs::Ismps, I);
+    IdischargeCutOff_ = AnalogInputs::reverseCalibrateValue(AnalogInputs::Idischarge, I);
+    if(limitsOn_)
+        setLimits(true, limitsCurrent_);
 }
 
 void hardware::setChargerValue(uint16_t value)
@@ -131,6 +157,7 @@ void hardware::setChargerOutput(bool enable)
         disableChargerBoost();
     }
     IO::digitalWrite(SMPS_DISABLE_PIN, !enable);
+    setLimits(enable, AnalogInputs::Ismps);
     if(enable) {
         SMPS_PID::init(AnalogInputs::getRealValue(AnalogInputs::Vin), AnalogInputs::getRealValue(AnalogInputs::Vout_plus_pin));
     }
@@ -141,6 +168,7 @@ void hardware::setDischargerOutput(bool enable)
 {
     if(enable) setChargerOutput(false);
     IO::digitalWrite(DISCHARGE_DISABLE_PIN, !enable);
+    setLimits(enable, AnalogInputs::Idischarge);
 }
 
 void hardware::setDischargerValue(uint16_t value)
@@ -44,6 +44,7 @@ namespace hardware {
     void setChargerValue(uint16_t value);
     void setDischargerValue(uint16_t value);
     void setVoutCutoff(AnalogInputs::ValueType v);
+    void setIoutCutoff(AnalogInputs::ValueType I);
 
     void setBalancer(uint8_t balance);
     void doInterrupt();
@@ -0,0 +1,238 @@
+#!/usr/bin/python3
+# -*- coding: utf-8 -*-
+#
+# cheali-fleetd - collect SerialLog telemetry from many chargers at once
+#
+# Every device is opened non-blocking and multiplexed with epoll, so a single
+# process keeps up with dozens of chargers. Each stream is parsed
+# incrementally; frames are appended to per-charger columnar archives
+#   <archive>/<charger>/ch<channel>/<column>.i32   (little-endian int32)
+# and a consolidated live status table is rewritten every --interval seconds.
+
+import argparse
+import array
+import errno
+import os
+import select
+import sys
+import termios
+import time
+
+from chealistream import StreamParser, column_names, BB3_CHANNEL
+
+BAUD = {
+    9600: termios.B9600,
+    19200: termios.B19200,
+    38400: termios.B38400,
+    57600: termios.B57600,
+    115200: termios.B115200,
+}
+
+READ_SIZE = 4096
+FLUSH_ROWS = 256
+REOPEN_PERIOD = 2.0
+
+
+class ColumnArchive(object):
+    """append-only column files of one channel"""
+
+    def __init__(self, path, channel, width):
+        self.path = os.path.join(path, "ch%d" % channel)
+        self.names = column_names(channel, width)
+        self.columns = [array.array("i") for _ in self.names]
+        self.rows = 0
+        if not os.path.isdir(self.path):
+            os.makedirs(self.path)
+        with open(os.path.join(self.path, "columns.txt"), "w") as f:
+            f.write("\n".join(self.names) + "\n")
+
+    def append(self, frame):
+        c = self.columns
+        c[0].append(frame.state)
+        c[1].append(frame.time)
+        for i, v in enumerate(frame.values):
+            c[i + 2].append(v)
+        self.rows += 1
+        if self.rows >= FLUSH_ROWS:
+            self.flush()
+
+    def flush(self):
+        if not self.rows:
+            return
+        for name, column in zip(self.names, self.columns):
+            if sys.byteorder != "little":
+                column.byteswap()
+            with open(os.path.join(self.path, name + ".i32"), "ab") as f:
+                column.tofile(f)
+            del column[:]
+        self.rows = 0
+
+
+class Charger(object):
+    def __init__(self, name, device, archive):
+        self.name = name
+        self.device = device
+        self.path = os.path.join(archive, name)
+        self.fd = -1
+        self.parser = StreamParser()
+        self.archives = {}
+        self.last = {}
+        self.bytes = 0
+        self.seen = 0.0
+        self.next_open = 0.0
+
+    def open(self, baud):
+        try:
+            fd = os.open(self.device, os.O_RDWR | os.O_NOCTTY | os.O_NONBLOCK)
+        except OSError:
+            return False
+        if os.isatty(fd):
+            attr = termios.tcgetattr(fd)
+            attr[0] = 0                                         # iflag
+            attr[1] = 0                                         # oflag
+            attr[2] = termios.CS8 | termios.CREAD | termios.CLOCAL
+            attr[3] = 0                                         # lflag
+            attr[4] = attr[5] = BAUD[baud]
+            attr[6][termios.VMIN] = 1
+            attr[6][termios.VTIME] = 0
+            termios.tcsetattr(fd, termios.TCSANOW, attr)
+        self.fd = fd
+        # a partial line from a previous connection is not a frame
+        self.parser.buf = b""
+        return True
+
+    def close(self):
+        if self.fd >= 0:
+            os.close(self.fd)
+        self.fd = -1
+        self.flush()
+
+    def read(self):
+        """drain the descriptor, returns False on hang-up"""
+        while True:
+            try:
+                data = os.read(self.fd, READ_SIZE)
+            except OSError as e:
+                if e.errno == errno.EAGAIN:
+                    return True
+                return False
+            if not data:
+                return False
+            self.bytes += len(data)
+            self.seen = time.time()
+            for frame in self.parser.feed(data, self.seen):
+                key = (frame.channel, len(frame.values))
+                a = self.archives.get(key)
+                if a is None:
+                    a = self.archives[key] = ColumnArchive(self.path, frame.channel, len(frame.values))
+                a.append(frame)
+                self.last[frame.channel] = frame
+            if len(data) < READ_SIZE:
+                return True
+
+    def flush(self):
+        for a in self.archives.values():
+            a.flush()
+
+
+def status_row(c, now, dt, last_bytes):
+    f = c.last.get(1) or c.last.get(BB3_CHANNEL)
+    p = c.parser
+    rate = (c.bytes - last_bytes) / dt if dt > 0 else 0
+    state = "online" if c.fd >= 0 else "offline"
+    if f is None:
+        v = "%-6s %10s %8s %8s %8s" % ("-", "-", "-", "-", "-")
+    else:
+        n = column_names(f.channel, len(f.values))
+        d = dict(zip(n[2:], f.values))
+        # BB3 lines: Charge in uAh
+        charge = d.get("Charge", 0) / (1e6 if f.channel == BB3_CHANNEL else 1e3)
+        v = "%-6d %10.1f %8.3f %8.3f %8.3f" % (f.state, f.time / 1000.,
+                d.get("Vout", 0) / 1000., d.get("Iout", 0) / 1000., charge)
+    age = "%.1f" % (now - c.seen) if c.seen else "-"
+    return "%-12s %-8s %s %8d %6d %6d %8.0f %6s" % (c.name, state, v,
+            p.frames, p.bad_crc + p.bad_format, p.overflows, rate, age)
+
+
+STATUS_HEADER = "%-12s %-8s %-6s %10s %8s %8s %8s %8s %6s %6s %8s %6s" % (
+    "charger", "link", "prog", "time[s]", "Vout[V]", "Iout[A]", "C[Ah]",
+    "frames", "errors", "ovf", "B/s", "age")
+
+
+def write_status(path, chargers, now, dt, last_bytes):
+    lines = [STATUS_HEADER]
+    for c in chargers:
+        lines.append(status_row(c, now, dt, last_bytes[c.name]))
+    text = "\n".join(lines) + "\n"
+    if path == "-":
+        sys.stdout.write("\x1b[H\x1b[2J" + text)
+        sys.stdout.flush()
+        return
+    tmp = path + ".tmp"
+    with open(tmp, "w") as f:
+        f.write(text)
+    os.rename(tmp, path)
+
+
+def main():
+    ap = argparse.ArgumentParser(description="cheali-charger fleet telemetry aggregator")
+    ap.add_argument("devices", nargs="+", help="serial devices, optionally NAME=DEVICE")
+    ap.add_argument("-b", "--baud", type=int, default=115200, choices=sorted(BAUD))
+    ap.add_argument("-a", "--archive", default="fleet-archive", help="archive directory")
+    ap.add_argument("-s", "--status", default="-", help="status table file ('-' = terminal)")
+    ap.add_argument("-i", "--interval", type=float, default=1.0, help="status period [s]")
+    ap.add_argument("-d", "--duration", type=float, default=0, help="stop after [s], 0 = run forever")
+    args = ap.parse_args()
+
+    chargers = []
+    for i, d in enumerate(args.devices):
+        name, sep, dev = d.partition("=")
+        if not sep:
+            name, dev = "charger%02d" % i, d
+        chargers.append(Charger(name, dev, args.archive))
+
+    ep = select.epoll()
+    byfd = {}
+    start = last_status = time.time()
+    last_bytes = dict((c.name, 0) for c in chargers)
+    try:
+        while True:
+            now = time.time()
+            for c in chargers:
+                if c.fd < 0 and now >= c.next_open:
+                    c.next_open = now + REOPEN_PERIOD
+                    if c.open(args.baud):
+                        ep.register(c.fd, select.EPOLLIN)
+                        byfd[c.fd] = c
+
+            timeout = max(0.0, last_status + args.interval - now)
+            for fd, ev in ep.poll(timeout):
+                c = byfd[fd]
+                alive = c.read() if ev & select.EPOLLIN else True
+                if not alive or ev & (select.EPOLLHUP | select.EPOLLERR) and not ev & select.EPOLLIN:
+                    ep.unregister(fd)
+                    del byfd[fd]
+                    c.close()
+
+            now = time.time()
+            if now - last_status >= args.interval:
+                write_status(args.status, chargers, now, now - last_status, last_bytes)
+                last_bytes = dict((c.name, c.bytes) for c in chargers)
+                last_status = now
+            if args.duration and now - start >= args.duration:
+                break
+    except KeyboardInterrupt:
+        pass
+    finally:
+        for c in chargers:
+            c.close()
+        ep.close()
+
+    for c in chargers:
+        p = c.parser
+        sys.stderr.write("%s: frames %d, bad crc %d, bad format %d, overflows %d, bytes %d\n" % (
+            c.name, p.frames, p.bad_crc, p.bad_format, p.overflows, c.bytes))
+
+
+if __name__ == "__main__":
+    main()
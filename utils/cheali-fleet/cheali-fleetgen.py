@@ -0,0 +1,158 @@
+#!/usr/bin/python3
+# -*- coding: utf-8 -*-
+#
+# cheali-fleetgen - load generator for cheali-fleetd
+#
+# Creates N pseudo terminals and streams synthetic SerialLog frames ("$" frames
+# or BB3 lines, --format) into them at the byte rate of a real UART (baud / 10 bytes per second, per charger).
+# The slave device names are printed on stdout, one per line, so they can be
+# passed straight to cheali-fleetd.py. On exit the number of frames sent per
+# charger is printed on stderr for comparison with the daemon summary.
+
+import argparse
+import errno
+import math
+import os
+import sys
+import time
+import tty
+
+from chealistream import encode_frame, encode_bb3, BB3_CHANNEL
+
+
+def make_values(i, t, cells):
+    # a charging battery with a bit of per-charger variation
+    x = t / 3600000.
+    vcell = int(3700 + 500 * (1 - math.exp(-x * 3)) + i)
+    vb = [vcell + (k * 3) % 7 for k in range(cells)]
+    vout = sum(vb)
+    iout = 2000 + 10 * i
+    charge = int(iout * x)
+    power = vout * iout // 10000
+    energy = int(power * x)
+    r = [20 + k for k in range(cells)]
+    return ([vout, iout, charge, power, energy, 2500, 3100 + i, 12000] + vb + r
+            + [sum(r), 5, min(99, int(x * 100)), max(0, int((1 - x) * 3600))])
+
+
+class Generator(object):
+    def __init__(self, i, args):
+        self.i = i
+        self.master, self.slave = os.openpty()
+        tty.setraw(self.slave)
+        self.name = os.ttyname(self.slave)
+        os.set_blocking(self.master, False)
+        self.cells = args.cells
+        self.rate = args.baud / 10. * args.speedup
+        self.t = 0
+        self.start = None
+        self.sent_bytes = 0
+        self.pending = b""
+        self.bb3 = args.format == "bb3"
+        self.frames = {BB3_CHANNEL: 0, 1: 0, 2: 0, 3: 0}
+
+    def next_frame(self):
+        self.t += 500
+        values = make_values(self.i, self.t, self.cells)
+        if self.bb3:
+            # Charge in uAh, Energy in uWh, Text is not sent
+            self.frames[BB3_CHANNEL] += 1
+            return encode_bb3(values[:2] + [values[2] * 1000, values[3], values[4] * 10000, 0]
+                              + values[6:8] + values[-4:-1])
+        out = encode_frame(1, 1, self.t, values)
+        self.frames[1] += 1
+        if self.t % 1000 == 0:
+            out += encode_frame(2, 1, self.t, [self.t % 4096 + k for k in range(20 + self.cells)])
+            self.frames[2] += 1
+        if self.t % 10000 == 0:
+            out += encode_frame(3, 1, self.t, [300, 200])
+            self.frames[3] += 1
+        return out
+
+    def pump(self, now):
+        """write as many bytes as the simulated UART could have sent by now"""
+        if self.start is None:
+            self.start = now
+        budget = int((now - self.start) * self.rate) - self.sent_bytes
+        while budget > 0:
+            if not self.pending:
+                self.pending = self.next_frame()
+            chunk = self.pending[:budget]
+            try:
+                n = os.write(self.master, chunk)
+            except OSError as e:
+                if e.errno == errno.EAGAIN:
+                    # reader is behind; a real UART would drop these bytes
+                    return False
+                raise
+            self.pending = self.pending[n:]
+            self.sent_bytes += n
+            budget -= n
+        return True
+
+    def finish(self):
+        """send the rest of a partially written frame"""
+        while self.pending:
+            try:
+                n = os.write(self.master, self.pending)
+            except OSError as e:
+                if e.errno != errno.EAGAIN:
+                    return
+                time.sleep(0.001)
+                continue
+            self.pending = self.pending[n:]
+            self.sent_bytes += n
+
+
+def main():
+    ap = argparse.ArgumentParser(description="SerialLog load generator for cheali-fleetd")
+    ap.add_argument("-n", "--chargers", type=int, default=32)
+    ap.add_argument("-b", "--baud", type=int, default=115200)
+    ap.add_argument("-c", "--cells", type=int, default=6, choices=(6, 8))
+    ap.add_argument("-f", "--format", default="frames", choices=("frames", "bb3"),
+                    help="'$' frames or BB3 lines (ENABLE_SERIAL_LOG_BB3)")
+    ap.add_argument("-x", "--speedup", type=float, default=1.0,
+                    help="multiply the UART byte rate (stress test)")
+    ap.add_argument("-d", "--duration", type=float, default=0, help="stop after [s], 0 = run forever")
+    ap.add_argument("-w", "--wait", type=float, default=1.0,
+                    help="pause before streaming, lets the reader open the devices")
+    args = ap.parse_args()
+
+    gens = [Generator(i, args) for i in range(args.chargers)]
+    for g in gens:
+        print(g.name)
+    sys.stdout.flush()
+    time.sleep(args.wait)
+
+    stalls = 0
+    start = time.time()
+    try:
+        while True:
+            now = time.time()
+            for g in gens:
+                if not g.pump(now):
+                    stalls += 1
+            if args.duration and now - start >= args.duration:
+                break
+            time.sleep(0.002)
+        # let the tail of every partially sent frame out
+        for g in gens:
+            g.finish()
+    except KeyboardInterrupt:
+        pass
+
+    total = 0
+    for g in gens:
+        total += g.sent_bytes
+        sys.stderr.write("%s: frames %d ($1 %d, $2 %d, $3 %d, BB3 %d), bytes %d\n" % (
+            g.name, sum(g.frames.values()), g.frames[1], g.frames[2], g.frames[3],
+            g.frames[BB3_CHANNEL], g.sent_bytes))
+    dt = time.time() - start
+    sys.stderr.write("total %d bytes in %.1f s (%.0f B/s), writer stalls %d\n" % (
+        total, dt, total / dt, stalls))
+    # keep the masters open until the reader saw everything
+    time.sleep(args.wait)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,178 @@
+#!/usr/bin/python3
+# -*- coding: utf-8 -*-
+#
+# incremental parser for the SerialLog stream, both formats of
+# src/core/drivers/SerialLog.cpp are accepted:
+#
+# "$" frames (ENABLE_SERIAL_LOG_BB3 not defined):
+#   $<channel>;<programType+1>;<seconds>.<tenths>;<v0>;<v1>;...;<vN>;<crc>\r\n
+# <crc> is the XOR of every character from '$' up to and including the
+# last ';'.
+#
+# BB3 SCPI lines (ENABLE_SERIAL_LOG_BB3), one per full measurement:
+#   SENS:DLOG:TRACE:DATA <Vout>, <Iout>, <Charge>, ..., <Percent>\r\n
+# decimal values without a checksum, program and time are not sent:
+# they become channel BB3_CHANNEL frames with state 0 and the receive time
+# (when feed() gets one). The other SCPI lines are counted as other_lines.
+
+MAX_LINE = 512
+
+CHANNEL1_HEAD = ["Vout", "Iout", "Charge", "Power", "Energy", "Text", "Tint", "Vin"]
+CHANNEL1_TAIL = ["Rbat", "Rwire", "Percent", "ETA"]
+
+BB3_CHANNEL = 0
+BB3_PREFIX = b"SENS:DLOG:TRACE:DATA "
+# column, decimal places: the archived integer is value * 10^places
+# (mV, mA, uAh, 0.01W, uWh, 0.01C, 0.01C, mV, mOhm, mOhm, %)
+BB3_COLUMNS = [("Vout", 3), ("Iout", 3), ("Charge", 6), ("Power", 2), ("Energy", 6),
+               ("Text", 2), ("Tint", 2), ("Vin", 3), ("Rbat", 3), ("Rwire", 3), ("Percent", 0)]
+
+
+def channel1_names(values):
+    """column names of a $1 frame with 'values' analog fields"""
+    cells = (values - len(CHANNEL1_HEAD) - len(CHANNEL1_TAIL)) // 2
+    if cells < 0 or len(CHANNEL1_HEAD) + 2 * cells + len(CHANNEL1_TAIL) != values:
+        return None
+    vb = ["Vb%d" % (i + 1) for i in range(cells)]
+    r = ["R%d" % (i + 1) for i in range(cells)]
+    return CHANNEL1_HEAD + vb + r + CHANNEL1_TAIL
+
+
+def column_names(channel, values):
+    names = None
+    if channel == 1:
+        names = channel1_names(values)
+    elif channel == BB3_CHANNEL and values == len(BB3_COLUMNS):
+        names = [n for n, _ in BB3_COLUMNS]
+    if names is None:
+        names = ["c%d" % i for i in range(values)]
+    return ["state", "time"] + names
+
+
+def crc(data):
+    c = 0
+    for b in data:
+        c ^= b
+    return c
+
+
+def encode_frame(channel, state, time_ms, values):
+    """build one frame exactly as SerialLog::sendHeader/sendEnd does"""
+    body = "$%d;%d;%d.%d;" % (channel, state, time_ms // 1000, (time_ms // 100) % 10)
+    body += "".join("%d;" % v for v in values)
+    body = body.encode("ascii")
+    return body + b"%d\r\n" % crc(body)
+
+
+def decimal(text, places):
+    """fixed point "12.345" -> 12345 (places=3) without rounding errors"""
+    whole, _, frac = text.strip().partition(b".")
+    if len(frac) > places or not frac.isdigit() and frac:
+        raise ValueError(text)
+    v = abs(int(whole)) * 10 ** places + int(frac.ljust(places, b"0") or b"0")
+    return -v if whole.startswith(b"-") else v
+
+
+def encode_bb3(values):
+    """build one BB3 line from BB3_COLUMNS integers, like SerialLog::sendChannel1"""
+    out = []
+    for v, (_, places) in zip(values, BB3_COLUMNS):
+        if places:
+            out.append("%d.%0*d" % (v // 10 ** places, places, v % 10 ** places))
+        else:
+            out.append("%d" % v)
+    return BB3_PREFIX + ", ".join(out).encode("ascii") + b"\r\n"
+
+
+class Frame(object):
+    __slots__ = ("channel", "state", "time", "values")
+
+    def __init__(self, channel, state, time, values):
+        self.channel = channel
+        self.state = state
+        self.time = time            # miliseconds
+        self.values = values
+
+
+class StreamParser(object):
+    """feed() arbitrary chunks, get back the complete frames they close"""
+
+    def __init__(self):
+        self.buf = b""
+        self.frames = 0
+        self.bad_crc = 0
+        self.bad_format = 0
+        self.overflows = 0
+        self.other_lines = 0
+        self.bb3_start = None
+
+    def feed(self, data, now=None):
+        """now: receive time [s] of 'data', the time of BB3 frames"""
+        out = []
+        buf = self.buf + data
+        start = 0
+        while True:
+            end = buf.find(b"\n", start)
+            if end < 0:
+                break
+            line = buf[start:end]
+            start = end + 1
+            line = line.rstrip(b"\r")
+            if line.startswith(BB3_PREFIX):
+                frame = self.parse_bb3(line[len(BB3_PREFIX):], now)
+            else:
+                frame = self.parse_line(line)
+            if frame is not None:
+                out.append(frame)
+        self.buf = buf[start:]
+        if len(self.buf) > MAX_LINE:
+            # garbage without a line end, resynchronize on the next '$'
+            self.overflows += 1
+            sync = self.buf.rfind(b"$")
+            self.buf = self.buf[sync:] if sync > 0 else b""
+        return out
+
+    def parse_line(self, line):
+        sync = line.find(b"$")
+        if sync < 0:
+            if line:
+                self.other_lines += 1
+            return None
+        line = line[sync:]
+        last = line.rfind(b";")
+        if last < 0:
+            self.bad_format += 1
+            return None
+        try:
+            if int(line[last + 1:]) != crc(line[:last + 1]):
+                self.bad_crc += 1
+                return None
+            fields = line[1:last].split(b";")
+            channel = int(fields[0])
+            state = int(fields[1])
+            sec, _, tenth = fields[2].partition(b".")
+            time = int(sec) * 1000 + int(tenth or b"0") * 100
+            values = [int(v) for v in fields[3:]]
+        except (ValueError, IndexError):
+            self.bad_format += 1
+            return None
+        self.frames += 1
+        return Frame(channel, state, time, values)
+
+    def parse_bb3(self, line, now):
+        fields = line.split(b",")
+        if len(fields) != len(BB3_COLUMNS):
+            self.bad_format += 1
+            return None
+        try:
+            values = [decimal(v, places) for v, (_, places) in zip(fields, BB3_COLUMNS)]
+        except ValueError:
+            self.bad_format += 1
+            return None
+        time = 0
+        if now is not None:
+            if self.bb3_start is None:
+                self.bb3_start = now
+            time = int((now - self.bb3_start) * 1000)
+        self.frames += 1
+        return Frame(BB3_CHANNEL, 0, time, values)
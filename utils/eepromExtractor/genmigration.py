@@ -0,0 +1,131 @@
+#!/usr/bin/python
+# -*- coding: utf-8 -*-
+#
+# generates src/core/eepromMigration.h from layouts.py
+#
+# usage: ./genmigration.py [output file]
+
+from __future__ import print_function
+import sys
+from layouts import SECTIONS, LAYOUTS
+
+OUTPUT = '../../src/core/eepromMigration.h'
+
+SECTION_FLAGS = {
+    'calibration': 'EEPROM_RESTORE_CALIBRATION',
+    'programData': 'EEPROM_RESTORE_PROGRAM_DATA',
+    'settings': 'EEPROM_RESTORE_SETTINGS',
+}
+
+HEADER = u'''/*
+    cheali-charger - open source firmware for a variety of LiPo chargers
+    Copyright (C) 2013  Paweł Stawicki. All right reserved.
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+// generated by utils/eepromExtractor/genmigration.py from layouts.py - do not edit
+#ifndef EEPROM_MIGRATION_H_
+#define EEPROM_MIGRATION_H_
+'''
+
+
+def offsets(fields):
+    retu = {}
+    offset = 0
+    for name, size in fields:
+        retu[name] = (offset, size)
+        offset += size
+    return retu, offset
+
+
+def getMoves(old, new):
+    """(from, to, size, names) runs of fields copied from the old record"""
+    oldOffsets, _ = offsets(old)
+    moves = []
+    offset = 0
+    for name, size in new:
+        if name in oldOffsets:
+            src, oldSize = oldOffsets[name]
+            if oldSize != size:
+                raise Exception('field ' + name + ' changed size')
+            last = moves[-1] if moves else None
+            if last and last[0] + last[2] == src and last[1] + last[2] == offset:
+                moves[-1] = (last[0], last[1], last[2] + size, last[3] + [name])
+            else:
+                moves.append((src, offset, size, [name]))
+        offset += size
+    return moves
+
+
+def generate():
+    out = [HEADER]
+    moves = []
+    migrations = []
+    maxRecord = 0
+    for section in SECTIONS:
+        versions = sorted(LAYOUTS[section].keys())
+        current = versions[-1]
+        new = LAYOUTS[section][current]
+        _, newSize = offsets(new)
+        flag = SECTION_FLAGS[section]
+        name = section.upper()
+        out.append('#define EEPROM_MIGRATION_%s_VERSION %d' % (name, current))
+        out.append('#define EEPROM_MIGRATION_%s_SIZE %d' % (name, newSize))
+        for version in versions[:-1]:
+            old = LAYOUTS[section][version]
+            _, oldSize = offsets(old)
+            # the firmware migrates a section only if the sections in front of it
+            # are valid, a size change would move the sections behind it
+            if section != SECTIONS[-1] and oldSize != newSize:
+                print('%s %d: sections behind it move, not supported' % (section, version), file=sys.stderr)
+                continue
+            # there are no per record defaults for the calibration
+            if section == 'calibration':
+                print('%s %d: not supported' % (section, version), file=sys.stderr)
+                continue
+            m = getMoves(old, new)
+            migrations.append('        {%s, %d, %d, %d, %d},' % (flag, version, oldSize, len(moves), len(m)))
+            moves += m
+            maxRecord = max(maxRecord, oldSize)
+
+    out.append('#define EEPROM_MIGRATION_MAX_RECORD %d' % max(maxRecord, 1))
+    out.append('')
+    out.append('namespace eeprom {')
+    out.append('    //{from, to, size} inside a record')
+    out.append('    const MigrationMove migrationMoves[] PROGMEM = {')
+    for src, dst, size, names in moves:
+        out.append('        {%d, %d, %d}, //%s' % (src, dst, size, ', '.join(names)))
+    if not moves:
+        out.append('        {0, 0, 0},')
+    out.append('    };')
+    out.append('    //{section, stored version, old record size, first move, moves}')
+    out.append('    const Migration migrations[] PROGMEM = {')
+    out += migrations
+    if not migrations:
+        out.append('        {0, 0, 0, 0, 0},')
+    out.append('    };')
+    out.append('} //namespace eeprom')
+    out.append('')
+    out.append('#endif /* EEPROM_MIGRATION_H_ */')
+    return '\n'.join(out) + '\n'
+
+
+if __name__ == '__main__':
+    output = OUTPUT
+    if len(sys.argv) > 1:
+        output = sys.argv[1]
+    text = generate()
+    f = open(output, 'wb')
+    f.write(text.encode('utf-8'))
+    f.close()
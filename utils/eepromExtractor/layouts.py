@@ -0,0 +1,85 @@
+# Layout of the eeprom records, one field list per stored section version.
+# The last version of every section must match the firmware (see CMakeLists.txt
+# and src/core/Settings.h, src/core/ProgramData.h), older versions describe
+# what is still found in chargers upgraded from earlier releases.
+#
+# Fields are matched by name when a record is migrated, new fields get the
+# firmware default. Run genmigration.py after changing this file.
+
+CALIBRATION = 'calibration'
+PROGRAM_DATA = 'programData'
+SETTINGS = 'settings'
+
+# eeprom order, a section can be migrated only if the sections in front of it
+# did not change (it must start at the same address)
+SECTIONS = [CALIBRATION, PROGRAM_DATA, SETTINGS]
+
+LAYOUTS = {
+    CALIBRATION: {
+        10: [
+            ('p0x', 2), ('p0y', 2),
+            ('p1x', 2), ('p1y', 2),
+        ],
+    },
+
+    PROGRAM_DATA: {
+        3: [
+            ('type', 2),
+            ('capacity', 2),
+            ('cells', 2),
+            ('Ic', 2),
+            ('Id', 2),
+            ('Vc_per_cell', 2),
+            ('Vd_per_cell', 2),
+            ('minIc', 2),
+            ('minId', 2),
+            ('time', 2),
+            ('enable_externT', 2),
+            ('externTCO', 2),
+            ('enable_adaptiveDischarge', 2),
+            ('DCRestTime', 2),
+            ('capCutoff', 2),
+            ('LiXX_NiXX', 10),     # union: Vs_per_cell, balancerError / enable_deltaV ... DCcycles
+        ],
+    },
+
+    SETTINGS: {
+        11: [
+            ('backlight', 2),
+            ('fanOn', 2),
+            ('fanTempOn', 2),
+            ('dischargeTempOff', 2),
+            ('audioBeep', 2),
+            ('minIc', 2),
+            ('maxIc', 2),
+            ('minId', 2),
+            ('maxId', 2),
+            ('inputVoltageLow', 2),
+            ('adcNoise', 2),
+            ('UART', 2),
+            ('UARTspeed', 2),
+            ('UARToutput', 2),
+            ('menuType', 2),
+        ],
+        12: [
+            ('backlight', 2),
+            ('fanOn', 2),
+            ('fanTempOn', 2),
+            ('dischargeTempOff', 2),
+            ('audioBeep', 2),
+            ('minIc', 2),
+            ('maxIc', 2),
+            ('minId', 2),
+            ('maxId', 2),
+            ('maxPc', 2),
+            ('maxPd', 2),
+            ('inputVoltageLow', 2),
+            ('adcNoise', 2),
+            ('UART', 2),
+            ('UARTspeed', 2),
+            ('UARToutput', 2),
+            ('menuType', 2),
+            ('menuButtons', 2),
+        ],
+    },
+}
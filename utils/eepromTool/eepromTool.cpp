@@ -0,0 +1,446 @@
+/*
+    cheali-charger - open source firmware for a variety of LiPo chargers
+    Copyright (C) 2013  Paweł Stawicki. All right reserved.
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+// cheali-eeprom: dump, check, diff and patch eeprom images of one target,
+// the layout comes from the firmware headers (eeprom::Data)
+
+#include "eeprom.h"
+#include "Version.h"
+
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+#include <type_traits>
+
+#ifndef CHEALI_TARGET_NAME
+#define CHEALI_TARGET_NAME "unknown"
+#endif
+
+namespace {
+
+    struct Field {
+        std::string name;
+        size_t offset;
+        size_t size;
+        bool isSigned;
+    };
+
+    std::vector<Field> fields_;
+
+    template<class T>
+    void add(const std::string &name, size_t offset) {
+        Field f = { name, offset, sizeof(T), std::is_signed<T>::value };
+        fields_.push_back(f);
+    }
+
+#define ADD(prefix, base, Type, field) \
+    add<decltype(((Type*)0)->field)>(std::string(prefix) + #field, (base) + offsetof(Type, field))
+
+    const char * const inputNames[] = {
+        "Vout_plus_pin", "Vout_minus_pin", "Ismps", "Idischarge",
+        "VoutMux", "Tintern", "Vin", "Textern",
+        "Vb0_pin", "Vb1_pin", "Vb2_pin", "Vb3_pin", "Vb4_pin", "Vb5_pin", "Vb6_pin",
+#if MAX_BALANCE_CELLS > 6
+        "Vb7_pin", "Vb8_pin",
+#endif
+        "IsmpsSet", "IdischargeSet",
+    };
+    static_assert(sizeof(inputNames)/sizeof(inputNames[0]) == AnalogInputs::PHYSICAL_INPUTS,
+            "see AnalogInputs::Name");
+
+    struct Section {
+        const char * name;
+        size_t offset;
+        size_t size;
+    };
+
+    const Section sections[] = {
+        { "calibration", offsetof(eeprom::Data, calibration), sizeof(eeprom::Data::calibration) },
+        { "battery", offsetof(eeprom::Data, battery), sizeof(eeprom::Data::battery) },
+        { "settings", offsetof(eeprom::Data, settings), sizeof(eeprom::Data::settings) },
+    };
+
+    void addHeader() {
+        add<uint32_t>("magicString", offsetof(eeprom::Data, magicString));
+        ADD("", 0, eeprom::Data, architecture);
+        ADD("", 0, eeprom::Data, architectureInfo);
+        ADD("", 0, eeprom::Data, calibrationVersion);
+        ADD("", 0, eeprom::Data, programDataVersion);
+        ADD("", 0, eeprom::Data, settingVersion);
+    }
+
+    void addCalibration() {
+        typedef AnalogInputs::Calibration C;
+        typedef AnalogInputs::CalibrationPoint P;
+        for(int i = 0; i < AnalogInputs::PHYSICAL_INPUTS; i++) {
+            size_t base = offsetof(eeprom::Data, calibration) + i * sizeof(C);
+            for(int j = 0; j < ANALOG_INPUTS_MAX_CALIBRATION_POINTS; j++) {
+                std::string prefix = std::string("calibration.") + inputNames[i] + ".p" + std::to_string(j) + ".";
+                size_t p = base + offsetof(C, p) + j * sizeof(P);
+                ADD(prefix, p, P, x);
+                ADD(prefix, p, P, y);
+            }
+        }
+        ADD("", 0, eeprom::Data, calibrationCRC);
+    }
+
+    void addBattery() {
+        typedef ProgramData::Battery B;
+        for(int i = 0; i < MAX_PROGRAMS; i++) {
+            std::string prefix = "battery[" + std::to_string(i) + "].";
+            size_t base = offsetof(eeprom::Data, battery) + i * sizeof(B);
+            ADD(prefix, base, B, type);
+            ADD(prefix, base, B, capacity);
+            ADD(prefix, base, B, cells);
+            ADD(prefix, base, B, Ic);
+            ADD(prefix, base, B, Id);
+            ADD(prefix, base, B, Vc_per_cell);
+            ADD(prefix, base, B, Vd_per_cell);
+            ADD(prefix, base, B, minIc);
+            ADD(prefix, base, B, minId);
+            ADD(prefix, base, B, time);
+            ADD(prefix, base, B, enable_externT);
+            ADD(prefix, base, B, externTCO);
+            ADD(prefix, base, B, enable_adaptiveDischarge);
+            ADD(prefix, base, B, DCRestTime);
+            ADD(prefix, base, B, capCutoff);
+            //union: LiXX
+            ADD(prefix, base, B, Vs_per_cell);
+            ADD(prefix, base, B, balancerError);
+            //union: NiXX
+            ADD(prefix, base, B, enable_deltaV);
+            ADD(prefix, base, B, deltaV);
+            ADD(prefix, base, B, deltaVIgnoreTime);
+            ADD(prefix, base, B, deltaT);
+            ADD(prefix, base, B, DCcycles);
+        }
+        ADD("", 0, eeprom::Data, batteryCRC);
+    }
+
+    void addSettings() {
+        size_t base = offsetof(eeprom::Data, settings);
+        ADD("settings.", base, Settings, backlight);
+        ADD("settings.", base, Settings, fanOn);
+        ADD("settings.", base, Settings, fanTempOn);
+        ADD("settings.", base, Settings, dischargeTempOff);
+        ADD("settings.", base, Settings, audioBeep);
+        ADD("settings.", base, Settings, minIc);
+        ADD("settings.", base, Settings, maxIc);
+        ADD("settings.", base, Settings, minId);
+        ADD("settings.", base, Settings, maxId);
+        ADD("settings.", base, Settings, maxPc);
+        ADD("settings.", base, Settings, maxPd);
+        ADD("settings.", base, Settings, inputVoltageLow);
+        ADD("settings.", base, Settings, adcNoise);
+        ADD("settings.", base, Settings, UART);
+        ADD("settings.", base, Settings, UARTspeed);
+        ADD("settings.", base, Settings, UARToutput);
+        ADD("settings.", base, Settings, menuType);
+        ADD("settings.", base, Settings, menuButtons);
+        ADD("", 0, eeprom::Data, settingsCRC);
+    }
+
+    //every byte of eeprom::Data must belong to a field,
+    //otherwise this file is out of date with the firmware headers
+    bool checkFields() {
+        std::vector<bool> covered(sizeof(eeprom::Data), false);
+        for(size_t i = 0; i < fields_.size(); i++) {
+            for(size_t j = 0; j < fields_[i].size; j++)
+                covered[fields_[i].offset + j] = true;
+        }
+        for(size_t i = 0; i < covered.size(); i++) {
+            if(!covered[i]) {
+                fprintf(stderr, "eeprom::Data byte %d has no field, update eepromTool.cpp\n", (int)i);
+                return false;
+            }
+        }
+        return true;
+    }
+
+    const Field * findField(const std::string &name) {
+        for(size_t i = 0; i < fields_.size(); i++) {
+            if(fields_[i].name == name)
+                return &fields_[i];
+        }
+        return NULL;
+    }
+
+    typedef std::vector<uint8_t> Image;
+
+    bool load(const char * file, Image &image) {
+        FILE * f = fopen(file, "rb");
+        if(!f) {
+            perror(file);
+            return false;
+        }
+        image.clear();
+        uint8_t buf[4096];
+        size_t n;
+        while((n = fread(buf, 1, sizeof(buf), f)) > 0)
+            image.insert(image.end(), buf, buf + n);
+        fclose(f);
+        if(image.size() < sizeof(eeprom::Data)) {
+            fprintf(stderr, "%s: too small (%d < %d bytes)\n", file, (int)image.size(), (int)sizeof(eeprom::Data));
+            return false;
+        }
+        return true;
+    }
+
+    bool save(const char * file, const Image &image) {
+        FILE * f = fopen(file, "wb");
+        if(!f || fwrite(&image[0], 1, image.size(), f) != image.size()) {
+            perror(file);
+            if(f) fclose(f);
+            return false;
+        }
+        fclose(f);
+        return true;
+    }
+
+    int64_t get(const Image &image, const Field &f) {
+        uint32_t v = 0;
+        for(size_t i = 0; i < f.size; i++)
+            v |= uint32_t(image[f.offset + i]) << (8 * i);
+        if(f.isSigned && f.size == 2)
+            return int16_t(v);
+        return v;
+    }
+
+    void set(Image &image, const Field &f, int64_t v) {
+        for(size_t i = 0; i < f.size; i++)
+            image[f.offset + i] = uint8_t(v >> (8 * i));
+    }
+
+    //the same CRC as eeprom::getCRC (CRC-16/MODBUS)
+    uint16_t getCRC(const Image &image, const Section &s) {
+        uint16_t crc = 0xffff;
+        for(size_t i = 0; i < s.size; i++) {
+            crc ^= image[s.offset + i];
+            for(int j = 0; j < 8; j++)
+                crc = (crc & 1) ? (crc >> 1) ^ 0xA001 : crc >> 1;
+        }
+        return crc;
+    }
+
+    uint16_t getStoredCRC(const Image &image, const Section &s) {
+        return image[s.offset + s.size] | (image[s.offset + s.size + 1] << 8);
+    }
+
+    void restoreCRC(Image &image, const Section &s) {
+        uint16_t crc = getCRC(image, s);
+        image[s.offset + s.size] = crc & 0xff;
+        image[s.offset + s.size + 1] = crc >> 8;
+    }
+
+    //returns a list of problems, empty if the image is valid for this target
+    std::string check(const Image &image) {
+        std::string retu;
+        if(memcmp(&image[offsetof(eeprom::Data, magicString)], "chli", 4))
+            retu += " magic";
+        const struct { const char * name; int64_t expected; } header[] = {
+            { "architecture", CHEALI_CHARGER_ARCHITECTURE },
+            { "architectureInfo", CHEALI_CHARGER_ARCHITECTURE_INFO },
+            { "calibrationVersion", CHEALI_CHARGER_EEPROM_CALIBRATION_VERSION },
+            { "programDataVersion", CHEALI_CHARGER_EEPROM_PROGRAMDATA_VERSION },
+            { "settingVersion", CHEALI_CHARGER_EEPROM_SETTINGS_VERSION },
+        };
+        for(size_t i = 0; i < sizeof(header)/sizeof(header[0]); i++) {
+            int64_t v = get(image, *findField(header[i].name));
+            if(v != header[i].expected)
+                retu += std::string(" ") + header[i].name + "=" + std::to_string(v);
+        }
+        for(size_t i = 0; i < sizeof(sections)/sizeof(sections[0]); i++) {
+            if(getCRC(image, sections[i]) != getStoredCRC(image, sections[i]))
+                retu += std::string(" ") + sections[i].name + "CRC";
+        }
+        return retu;
+    }
+
+    int cmdInfo() {
+        printf("target: %s\n", CHEALI_TARGET_NAME);
+        printf("architecture: 0x%x (%s)\n", CHEALI_CHARGER_ARCHITECTURE, CHEALI_CHARGER_ARCHITECTURE_CPU_STRING);
+        printf("architectureInfo: %d\n", CHEALI_CHARGER_ARCHITECTURE_INFO);
+        printf("eeprom version: %d.%d.%d\n", CHEALI_CHARGER_EEPROM_CALIBRATION_VERSION,
+                CHEALI_CHARGER_EEPROM_PROGRAMDATA_VERSION, CHEALI_CHARGER_EEPROM_SETTINGS_VERSION);
+        printf("size: %d bytes\n", (int)sizeof(eeprom::Data));
+        return 0;
+    }
+
+    int cmdCheck(int argc, char * argv[]) {
+        int bad = 0;
+        Image image;
+        for(int i = 0; i < argc; i++) {
+            std::string problems = "unreadable";
+            if(load(argv[i], image))
+                problems = check(image);
+            if(problems.empty()) {
+                printf("%s: OK\n", argv[i]);
+            } else {
+                printf("%s: BAD%s\n", argv[i], problems.c_str());
+                bad++;
+            }
+        }
+        return bad ? 1 : 0;
+    }
+
+    int cmdDump(int argc, char * argv[]) {
+        Image image;
+        for(int i = 0; i < argc; i++) {
+            if(!load(argv[i], image))
+                return 1;
+            if(argc > 1)
+                printf("# %s\n", argv[i]);
+            printf("magicString=%.4s\n", (const char *)&image[0]);
+            for(size_t j = 1; j < fields_.size(); j++)
+                printf("%s=%lld\n", fields_[j].name.c_str(), (long long)get(image, fields_[j]));
+        }
+        return 0;
+    }
+
+    int cmdDiff(const char * a, const char * b) {
+        Image ia, ib;
+        if(!load(a, ia) || !load(b, ib))
+            return 2;
+        int diff = 0;
+        for(size_t i = 0; i < fields_.size(); i++) {
+            int64_t va = get(ia, fields_[i]), vb = get(ib, fields_[i]);
+            if(va != vb) {
+                printf("%s: %lld -> %lld\n", fields_[i].name.c_str(), (long long)va, (long long)vb);
+                diff = 1;
+            }
+        }
+        return diff;
+    }
+
+    int cmdPatch(const char * in, const char * out, int argc, char * argv[]) {
+        Image image;
+        if(!load(in, image))
+            return 1;
+        for(int i = 0; i < argc; i++) {
+            const char * eq = strchr(argv[i], '=');
+            const Field * f = eq ? findField(std::string(argv[i], eq - argv[i])) : NULL;
+            if(!f) {
+                fprintf(stderr, "unknown field: %s\n", argv[i]);
+                return 1;
+            }
+            set(image, *f, strtoll(eq + 1, NULL, 0));
+        }
+        for(size_t i = 0; i < sizeof(sections)/sizeof(sections[0]); i++)
+            restoreCRC(image, sections[i]);
+        return save(out, image) ? 0 : 1;
+    }
+
+    int cmdCalibration(const char * in, const char * out) {
+        Image image;
+        if(!load(in, image))
+            return 1;
+        std::string problems = check(image);
+        if(!problems.empty()) {
+            fprintf(stderr, "%s: BAD%s\n", in, problems.c_str());
+            return 1;
+        }
+        FILE * f = out ? fopen(out, "w") : stdout;
+        if(!f) {
+            perror(out);
+            return 1;
+        }
+        fprintf(f, "/*\n"
+                "    cheali-charger - open source firmware for a variety of LiPo chargers\n"
+                "    Copyright (C) 2013  Pawe\xc5\x82 Stawicki. All right reserved.\n"
+                "\n"
+                "    This program is free software: you can redistribute it and/or modify\n"
+                "    it under the terms of the GNU General Public License as published by\n"
+                "    the Free Software Foundation, either version 3 of the License, or\n"
+                "    (at your option) any later version.\n"
+                "\n"
+                "    This program is distributed in the hope that it will be useful,\n"
+                "    but WITHOUT ANY WARRANTY; without even the implied warranty of\n"
+                "    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the\n"
+                "    GNU General Public License for more details.\n"
+                "\n"
+                "    You should have received a copy of the GNU General Public License\n"
+                "    along with this program.  If not, see <http://www.gnu.org/licenses/>.\n"
+                "*/\n"
+                "\n"
+                "#include \"AnalogInputsPrivate.h\"\n"
+                "#include \"memory.h\"\n"
+                "#include \"Utils.h\"\n"
+                "\n"
+                "const AnalogInputs::DefaultValues AnalogInputs::inputsP_[] PROGMEM = {\n");
+        for(int i = 0; i < AnalogInputs::PHYSICAL_INPUTS; i++) {
+            std::string prefix = std::string("calibration.") + inputNames[i] + ".p";
+            int64_t v[4] = {
+                get(image, *findField(prefix + "0.x")), get(image, *findField(prefix + "0.y")),
+                get(image, *findField(prefix + "1.x")), get(image, *findField(prefix + "1.y")),
+            };
+            fprintf(f, "    {{%lld, %lld},%*s{%lld, %lld}},   //%s\n",
+                    (long long)v[0], (long long)v[1], 8, "", (long long)v[2], (long long)v[3], inputNames[i]);
+        }
+        fprintf(f, "};\n"
+                "\n"
+                "namespace {\n"
+                "    void assert() {\n"
+                "        STATIC_ASSERT(sizeOfArray(AnalogInputs::inputsP_) == AnalogInputs::PHYSICAL_INPUTS);\n"
+                "    }\n"
+                "}\n");
+        if(out)
+            fclose(f);
+        return 0;
+    }
+
+    int usage(const char * name) {
+        fprintf(stderr,
+                "usage: %s <command> ...   (target: " CHEALI_TARGET_NAME ")\n"
+                "  info                         layout and versions of this target\n"
+                "  check <image>...             header and CRCs, exit code 1 if any image is bad\n"
+                "  dump <image>...              all fields as name=value\n"
+                "  diff <a> <b>                 fields that differ\n"
+                "  patch <in> <out> name=v...   set fields, recalculate the CRCs\n"
+                "  calibration <image> [out]    write defaultCalibration.cpp\n", name);
+        return 2;
+    }
+}
+
+int main(int argc, char * argv[])
+{
+    addHeader();
+    addCalibration();
+    addBattery();
+    addSettings();
+    if(!checkFields())
+        return 3;
+
+    if(argc < 2)
+        return usage(argv[0]);
+    std::string cmd = argv[1];
+    if(cmd == "info")
+        return cmdInfo();
+    if(cmd == "check" && argc > 2)
+        return cmdCheck(argc - 2, argv + 2);
+    if(cmd == "dump" && argc > 2)
+        return cmdDump(argc - 2, argv + 2);
+    if(cmd == "diff" && argc == 4)
+        return cmdDiff(argv[2], argv[3]);
+    if(cmd == "patch" && argc >= 4)
+        return cmdPatch(argv[2], argv[3], argc - 4, argv + 4);
+    if(cmd == "calibration" && (argc == 3 || argc == 4))
+        return cmdCalibration(argv[2], argc == 4 ? argv[3] : NULL);
+    return usage(argv[0]);
+}